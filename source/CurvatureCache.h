@@ -0,0 +1,152 @@
+#ifndef CURVATURECACHE_H
+#define CURVATURECACHE_H
+
+#include "MappedFile.h"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+/***************************************************************************
+CurvatureCache.h
+Comment:  This file contains a cache of the results of load() (normals, curvatures, percentiles).
+***************************************************************************/
+
+/**
+ * A curvature cache is a file written next to the mesh (path + ".curvcache") with:
+ * - CurvatureCacheHeader,
+ * - the float arrays, one after the other, in the order given by the caller (the order of the uploads of Object::init).
+ * Everything is a pure function of the content of the mesh file, so the cache is keyed by a hash of the content
+ * (moving or touching the file does not invalidate it) and by the options of the loader (settings_key).
+ */
+const int CURVATURE_CACHE_ARRAYS = 14;
+const int CURVATURE_CACHE_BOUNDS = 6;
+
+struct CurvatureCacheHeader
+{
+    char magic[8];                          // "CURVBIN"
+    uint32_t version;                       // CURVATURE_CACHE_VERSION
+    uint32_t arrays_count;                  // CURVATURE_CACHE_ARRAYS
+    uint64_t content_hash;                  // hash of the mesh file
+    uint64_t settings_key;                  // options of the loader that change the results
+    uint64_t sizes[CURVATURE_CACHE_ARRAYS]; // number of floats of each array
+    double bounds[CURVATURE_CACHE_BOUNDS];  // k-percentile bounds (min/max gc, mc edge, mc vertex)
+};
+
+const char CURVATURE_CACHE_MAGIC[8] = "CURVBIN";
+const uint32_t CURVATURE_CACHE_VERSION = 4; // increase it when the results of load() change
+
+/**
+ * Path of the curvature cache of a mesh.
+ */
+inline std::string get_curvature_cache_path(const char *path)
+{
+    return std::string(path) + ".curvcache";
+}
+
+/**
+ * Hash of the content of a file (64 bits, 8 bytes at a time).
+ */
+inline bool hash_file_content(const char *path, uint64_t &hash)
+{
+    MappedFile file;
+    if (!file.open(path))
+        return false;
+
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    hash = 0xCBF29CE484222325ULL ^ (file.size() * multiplier);
+
+    const char *p = file.begin();
+    size_t words = file.size() / 8;
+    for (size_t i = 0; i < words; i++, p += 8)
+    {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    for (; p < file.end(); p++)
+        hash = (hash ^ (unsigned char)*p) * multiplier;
+
+    hash ^= hash >> 32;
+    return true;
+}
+
+/**
+ * Read the curvature cache of the mesh at path into arrays and bounds. Return false if there is no valid cache
+ * for the current content of the file and settings_key.
+ */
+inline bool read_curvature_cache(const char *path, uint64_t settings_key, std::vector<float> *arrays[CURVATURE_CACHE_ARRAYS], double bounds[CURVATURE_CACHE_BOUNDS])
+{
+    MappedFile file;
+    if (!file.open(get_curvature_cache_path(path).c_str()) || file.size() < sizeof(CurvatureCacheHeader))
+        return false;
+
+    CurvatureCacheHeader header;
+    memcpy(&header, file.begin(), sizeof(header));
+    if (memcmp(header.magic, CURVATURE_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != CURVATURE_CACHE_VERSION ||
+        header.arrays_count != CURVATURE_CACHE_ARRAYS || header.settings_key != settings_key)
+        return false;
+
+    uint64_t content_hash;
+    if (!hash_file_content(path, content_hash) || content_hash != header.content_hash)
+        return false;
+
+    size_t total_size = sizeof(header);
+    for (int i = 0; i < CURVATURE_CACHE_ARRAYS; i++)
+        total_size += header.sizes[i] * sizeof(float);
+    if (file.size() != total_size)
+        return false;
+
+    const char *data = file.begin() + sizeof(header);
+    for (int i = 0; i < CURVATURE_CACHE_ARRAYS; i++)
+    {
+        arrays[i]->resize(header.sizes[i]);
+        if (header.sizes[i] > 0)
+            memcpy(&(*arrays[i])[0], data, header.sizes[i] * sizeof(float));
+        data += header.sizes[i] * sizeof(float);
+    }
+    memcpy(bounds, header.bounds, sizeof(header.bounds));
+    return true;
+}
+
+/**
+ * Write the curvature cache of the mesh at path (in a temporary file of this thread, see get_temporary_path, that is
+ * then renamed).
+ */
+inline bool write_curvature_cache(const char *path, uint64_t settings_key, std::vector<float> *arrays[CURVATURE_CACHE_ARRAYS], const double bounds[CURVATURE_CACHE_BOUNDS])
+{
+    CurvatureCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!hash_file_content(path, header.content_hash))
+        return false;
+    memcpy(header.magic, CURVATURE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = CURVATURE_CACHE_VERSION;
+    header.arrays_count = CURVATURE_CACHE_ARRAYS;
+    header.settings_key = settings_key;
+    for (int i = 0; i < CURVATURE_CACHE_ARRAYS; i++)
+        header.sizes[i] = arrays[i]->size();
+    memcpy(header.bounds, bounds, sizeof(header.bounds));
+
+    std::string cache_path = get_curvature_cache_path(path);
+    std::string temporary_path = get_temporary_path(cache_path);
+    FILE *file = fopen(temporary_path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    bool is_written = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int i = 0; is_written && i < CURVATURE_CACHE_ARRAYS; i++)
+        if (!arrays[i]->empty())
+            is_written = fwrite(&(*arrays[i])[0], sizeof(float), arrays[i]->size(), file) == arrays[i]->size();
+
+    is_written = (fclose(file) == 0) && is_written;
+    if (!is_written || rename(temporary_path.c_str(), cache_path.c_str()) != 0)
+    {
+        remove(temporary_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef CURVATUREESTIMATORS_H
+#define CURVATUREESTIMATORS_H
+
+/***************************************************************************
+CurvatureEstimators.h
+Comment:  This file contains the estimators of the area of a vertex and the sets of curvature estimators of MeshCurvature.
+***************************************************************************/
+
+/**
+ * Both are template parameters of BasicMeshCurvature (LoaderObject.h), chosen at compile time:
+ * - an area estimator gives the part of the area of a vertex in each triangle around it (the area of the vertex is the
+ *   sum of these parts), used by the Gaussian curvature and by the mean curvature per vertex;
+ * - a CurvatureEstimators set tells which curvatures are computed. The tests are on constants, so the code of the
+ *   estimators not in the set is removed by the compiler, and the chosen ones share the same loops over the triangles,
+ *   the edges and the vertices. The outputs of the estimators not in the set are 0.
+ * The parts of the area are computed from the dot products of the corners (a * b for the edge vectors a, b of a
+ * corner, negative at an obtuse corner), their cotangents and the squared lengths of the edges opposite to the
+ * corners (see get_triangle_corners in LoaderObject.h). get_corner_areas_avx2 (TriangleKernel.h) is the same for
+ * 4 triangles at a time.
+ */
+
+/**
+ * Voronoi region of the vertex of a corner of a triangle (circumcenter of the triangle): (|PR|^2 cot(Q) + |PQ|^2 cot(R)) / 8
+ * for the corner P of [P, Q, R]. The other corners are taken in increasing order.
+ */
+template <typename Scalar>
+inline Scalar get_corner_voronoi_area(int corner, const Scalar cot[3], const Scalar squared_length[3])
+{
+    int first = corner == 0 ? 1 : 0;
+    int second = corner == 2 ? 1 : 2;
+    return (squared_length[first] * cot[first] + squared_length[second] * cot[second]) / 8;
+}
+
+/**
+ * Area mixed (Meyer, Desbrun, Schroder, Barr, "Discrete Differential-Geometry Operators for Triangulated 2-Manifolds",
+ * section 3.3): the Voronoi region in a non-obtuse triangle, else half of the area at the obtuse corner and a quarter at the others.
+ */
+struct MixedVoronoiArea
+{
+    static const int id = 0;
+
+    static const char *get_name()
+    {
+        return "mixed";
+    }
+
+    template <typename Scalar>
+    static void get_corner_areas(const Scalar dot[3], const Scalar cot[3], const Scalar squared_length[3], Scalar area_triangle, Scalar corner_area[3])
+    {
+        if (dot[0] >= 0 && dot[1] >= 0 && dot[2] >= 0) // Triangle is not obtuse -> Voronoi-safe
+        {
+            for (int c = 0; c < 3; c++)
+                corner_area[c] = get_corner_voronoi_area(c, cot, squared_length);
+        }
+        else // Voronoi inappropriate
+        {
+            for (int c = 0; c < 3; c++)
+                corner_area[c] = dot[c] < 0 ? area_triangle / 2 : area_triangle / 4;
+        }
+    }
+};
+
+/**
+ * Barycentric area: a third of the area of each triangle (always positive, but not centered on the vertex).
+ */
+struct BarycentricArea
+{
+    static const int id = 1;
+
+    static const char *get_name()
+    {
+        return "barycentric";
+    }
+
+    template <typename Scalar>
+    static void get_corner_areas(const Scalar dot[3], const Scalar cot[3], const Scalar squared_length[3], Scalar area_triangle, Scalar corner_area[3])
+    {
+        for (int c = 0; c < 3; c++)
+            corner_area[c] = area_triangle / 3;
+    }
+};
+
+/**
+ * Circumcentric (pure Voronoi) area: the Voronoi region in every triangle. In an obtuse triangle the circumcenter is
+ * outside, the parts of the 2 other corners can be negative (the areas still tile the surface).
+ */
+struct CircumcentricArea
+{
+    static const int id = 2;
+
+    static const char *get_name()
+    {
+        return "circumcentric";
+    }
+
+    template <typename Scalar>
+    static void get_corner_areas(const Scalar dot[3], const Scalar cot[3], const Scalar squared_length[3], Scalar area_triangle, Scalar corner_area[3])
+    {
+        for (int c = 0; c < 3; c++)
+            corner_area[c] = get_corner_voronoi_area(c, cot, squared_length);
+    }
+};
+
+/**
+ * Set of curvature estimators computed by the engine:
+ * - AngleDefect: Gaussian curvature per vertex, (2 pi - sum of the angles) / area of the vertex;
+ * - DihedralMean: mean curvature per edge, ||E|| * theta / 2 / (area of the 2 triangles / 3) with the dihedral angle theta;
+ * - CotanMean: mean curvature per vertex, |sum (cot alpha + cot beta) (x_i - x_j)| / (4 * area of the vertex) (cotangent Laplacian).
+ */
+template <bool AngleDefect, bool DihedralMean, bool CotanMean>
+struct CurvatureEstimators
+{
+    static const bool has_angle_defect = AngleDefect;
+    static const bool has_dihedral_mean = DihedralMean;
+    static const bool has_cotan_mean = CotanMean;
+
+    // the angles of the corners and the areas of the vertices are computed only if an estimator uses them
+    static const bool has_corner_angles = AngleDefect;
+    static const bool has_vertex_areas = AngleDefect || CotanMean;
+
+    // the principal curvatures need the Gaussian and the mean curvature of the vertices (see PrincipalCurvatures.h)
+    static const bool has_principal_curvatures = AngleDefect && CotanMean;
+
+    // estimators not in the set (0 for all of them), part of the key of the settings
+    static const int missing_flags = (AngleDefect ? 0 : 1) | (DihedralMean ? 0 : 2) | (CotanMean ? 0 : 4);
+};
+
+typedef CurvatureEstimators<true, true, true> AllCurvatureEstimators;
+typedef CurvatureEstimators<true, false, false> GaussianCurvatureEstimator;
+typedef CurvatureEstimators<false, true, false> DihedralMeanCurvatureEstimator;
+typedef CurvatureEstimators<false, false, true> CotanMeanCurvatureEstimator;
+
+#endif
@@ -2,12 +2,30 @@
 #define LOADER_H
 
 #include "Point3.h"
+#include "MappedFile.h"
+#include "MeshTokenizer.h"
+#include "MeshCache.h"
+#include "PlyReader.h"
+#include "ObjReader.h"
+#include "VertexWelding.h"
+#include "MeshReorder.h"
+#include "MeshEdges.h"
+#include "VertexAdjacency.h"
+#include "ParallelFor.h"
+#include "VertexPositions.h"
+#include "TriangleKernel.h"
+#include "CurvatureEstimators.h"
+#include "PrincipalCurvatures.h"
 #include <vector>
+#include <algorithm>
+#include <numeric>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <map>
 #include <iterator>
+#include <thread>
+#include <atomic>
+#include <limits>
 #include "glm/ext.hpp"
 
 #define _USE_MATH_DEFINES
@@ -25,780 +43,1500 @@ using namespace std;
 
 /***************************************************************************
 LoaderObject.h
-Comment:  This file load the mesh using an .OFF file.
+Comment:  This file load the mesh using an .OFF file (or .PLY, .OBJ).
 ***************************************************************************/
 // ----- SET UP DATA AND VERTICES -----
-vector<Point3d> v; // vector of vertices
-
 struct Triangle
 {
     int v[3];
     Point3d n;
 };
-vector<Triangle> t; // vector of triangles
-
-static int num_triangles; // number of triangles in the mesh
-static int num_vertices;  // number of vertices in the mesh
-// -------------------------
-
-// ----- CROP DATA BETWEEN [-1, 1] -----
-// minimum and maximum value found in the mesh
-double min_coord = 0.0f;
-double max_coord = 0.0f;
 
 // interval of loaded mesh will be from -1 to 1
-int interval = 2; // max - min = 1 - (-1)
-// -------------------------
-
-// ----- MEAN CURVATURE -----
-struct edge
-{
-    float norm_edge;
-    int index_v1;
-    int index_v2;
-    Point3d n1;
-    Point3d n2;
-    float value_mean_curvature;
-    float cot_alpha;
-    float cot_beta;
-    float area_t1;
-    float area_t2;
-};
-
-// map for struct edge
-std::map<vector<int>, edge> map_edge; // key: [index_v1, index_v2]    val: struct edge
-
-vector<float> vector_mc_sum;
-
-// vector that contains a new surface area for each vertex x, denoted A_Mixed: for each non-obtuse triangle, we
-// use the circumcenter point, and for each obtuse triangle, we use the midpoint
-// of the edge opposite to the obtuse angle
-vector<float> area_mixed;
-vector<Point3d> mean_curvature_vertex_sum;
-
-// counter obtuse triangle and not-obtuse triangle
-int number_obtuse_triangle;
-int number_non_obtuse_triangle;
+const int interval = 2; // max - min = 1 - (-1)
 // -------------------------
 
 /**
- * Function to rescale a coord such that the coords is in a range between -1 and 1.
+ * Function to rescale a coord such that the coords is in a range between -1 and 1 (min_coord and max_coord are the
+ * minimum and the maximum value found in the mesh).
 */
-Point3d get_rescaled_value(Point3d value)
+Point3d get_rescaled_value(Point3d value, double min_coord, double max_coord)
 {
     // return value;                                                        // TODO: need to remove afer
     return interval / (max_coord - min_coord) * (value - max_coord) + 1; //1 is the max of interval
 }
 
 /**
- * Function to get the cotangent of an angle
+ * Function to update the minimum and the maximum value found in coords of an object.
  */
-double get_cotangent(double angle)
+void set_min_max(Point3d current, double &min_coord, double &max_coord)
 {
-    return cos(angle) / sin(angle);
+    min_coord = fmin(fmin(current.x(), current.y()), fmin(current.z(), min_coord));
+    max_coord = fmax(fmax(current.x(), current.y()), fmax(current.z(), max_coord));
 }
 
 /**
- * Get distance between 2 points
+ * Geometry of triangle [v0, v1, v2] without angles in between: with the edge vectors a, b of a corner,
+ * cot = (a * b) / |a ^ b| and the corner is obtuse if a * b < 0, where |a ^ b| = |(v1 - v0) ^ (v2 - v0)| is twice
+ * the area for the 3 corners. The angles are computed only for the angle defect, with one atan2 each.
+ * The parts of the areas of the vertices are given by AreaEstimator (see CurvatureEstimators.h): with MixedVoronoiArea
+ * the Voronoi region of P in a non-obtuse triangle [P, Q, R] is (|PR|^2 cot(Q) + |PQ|^2 cot(R)) / 8
+ * (http://www.geometry.caltech.edu/pubs/DMSB_III.pdf, section 3.3), else the part of the Area mixed is half (obtuse corner) or a quarter of the area.
+ * Write the face normal and angle, cot and part of the area of the 3 corners (angle only if Estimators has the angle
+ * defect, area only if it uses the areas of the vertices), and if laplacian is not NULL the cotangent Laplacian of the
+ * corners: for corner P of [P, Q, R], cot(R) (P - Q) + cot(Q) (P - R), its part of the mean curvature normal of P.
+ * Return the area of the triangle. Everything is computed in Scalar.
  */
-double get_distance_points(Point3d v0, Point3d v1)
+template <typename AreaEstimator = MixedVoronoiArea, typename Estimators = AllCurvatureEstimators, typename Scalar>
+inline Scalar get_triangle_corners(const Point3<Scalar> &v0, const Point3<Scalar> &v1, const Point3<Scalar> &v2, Point3<Scalar> &normal, Scalar angle[3], Scalar cot[3], Scalar area_mixed[3], Point3<Scalar> *laplacian = NULL)
 {
-    return abs(sqrt(pow((v0[0] - v1[0]), 2) + pow((v0[1] - v1[1]), 2) + pow((v0[2] - v1[2]), 2)));
+    Point3<Scalar> v0v1 = v1 - v0;
+    Point3<Scalar> v0v2 = v2 - v0;
+    Point3<Scalar> v1v2 = v2 - v1;
+
+    // -- normal and area ---
+    normal = v0v1 ^ v0v2;
+    Scalar cross_norm = normal.norm();
+    normal.normalize();
+    Scalar area_triangle = cross_norm / 2;
+
+    // -- corner 0 (v1 -> v0 -> v2), 1 (v2 -> v1 -> v0), 2 (v0 -> v2 -> v1) ---
+    Scalar dot[3] = {v0v1 * v0v2, -(v0v1 * v1v2), v0v2 * v1v2};
+    for (int c = 0; c < 3; c++)
+    {
+        if (Estimators::has_corner_angles)
+            angle[c] = atan2(cross_norm, dot[c]);
+        cot[c] = dot[c] / cross_norm;
+    }
+
+    // -- area of the vertices (squared lengths of the edges opposite to the corners) ---
+    if (Estimators::has_vertex_areas)
+    {
+        Scalar squared_length[3] = {v1v2 * v1v2, v0v2 * v0v2, v0v1 * v0v1};
+        AreaEstimator::get_corner_areas(dot, cot, squared_length, area_triangle, area_mixed);
+    }
+
+    // -- cotangent Laplacian (v0 - v1 = -v0v1, ...) ---
+    if (laplacian)
+    {
+        laplacian[0] = -(v0v1 * cot[2] + v0v2 * cot[1]);
+        laplacian[1] = v0v1 * cot[2] - v1v2 * cot[0];
+        laplacian[2] = v0v2 * cot[1] + v1v2 * cot[0];
+    }
+    return area_triangle;
 }
 
 /**
- * Function to return the index of 2 triangles that share the same edge. index_v1 and index_v2 represent the endpoint of an edge.
+ * Geometry of the triangles begin ... end - 1 (normals written in the triangles), from the rescaled positions x, y, z
+ * (see VertexPositions.h) widened to Scalar: angles, cotangents, parts of the areas of the vertices and cotangent
+ * Laplacian of their corners, areas (the values not used by Estimators and the NULL arrays of geometry are not written).
  */
-vector<int> get_triangle_by_edge(int index_v1, int index_v2)
+template <typename AreaEstimator = MixedVoronoiArea, typename Estimators = AllCurvatureEstimators, typename TriangleType, typename Position, typename Scalar>
+void compute_triangle_geometry_scalar(TriangleType *triangles, const Position *x, const Position *y, const Position *z, int begin, int end, const TriangleGeometry<Scalar> &geometry)
 {
-    int index_t1 = -1;
-    int index_t2 = -1;
-    for (int i = 0; i < num_triangles; i++)
+    for (int k = begin; k < end; k++)
     {
-        if (((t[i].v[0] == index_v1) || (t[i].v[1] == index_v1) || (t[i].v[1] == index_v1)) && ((t[i].v[0] == index_v2) || (t[i].v[1] == index_v2) || (t[i].v[1] == index_v2)))
+        int index_v0 = triangles[k].v[0], index_v1 = triangles[k].v[1], index_v2 = triangles[k].v[2];
+        Point3<Scalar> v0(x[index_v0], y[index_v0], z[index_v0]);
+        Point3<Scalar> v1(x[index_v1], y[index_v1], z[index_v1]);
+        Point3<Scalar> v2(x[index_v2], y[index_v2], z[index_v2]);
+
+        // angle opposite to edge v1v2, v2v0, v0v1 (corner 0, 1, 2): summed per vertex for gc, cotangents for mc per edge
+        Point3<Scalar> normal, laplacian[3];
+        Scalar angle[3], cot[3], area_mixed[3];
+        geometry.triangle_area[k] = get_triangle_corners<AreaEstimator, Estimators>(v0, v1, v2, normal, angle, cot, area_mixed, geometry.corner_laplacian ? laplacian : NULL);
+        triangles[k].n = Point3d(normal);
+        for (int c = 0; c < 3; c++)
         {
-            if (index_t1 == -1)
-            {
-                index_t1 = i;
-            }
-            else if (index_t2 == -1)
-            {
-                index_t2 = i;
-            }
-            else
-            {
-                cout << "ERROR EDGE SHARED BETWEEN MORE THAN 2 TRIANGLES" << endl;
-                exit(-1);
-            }
+            if (Estimators::has_corner_angles)
+                geometry.corner_angle[k * 3 + c] = angle[c];
+            if (geometry.corner_cot)
+                geometry.corner_cot[k * 3 + c] = cot[c];
+            if (Estimators::has_vertex_areas)
+                geometry.corner_area_mixed[k * 3 + c] = area_mixed[c];
+            if (geometry.corner_laplacian)
+                for (int j = 0; j < 3; j++)
+                    geometry.corner_laplacian[(k * 3 + c) * 3 + j] = laplacian[c][j];
         }
     }
-    return {index_t1, index_t2};
 }
 
 /**
- * Return the normal of an edge given 2 endpoints of an edge
+ * Geometry of the triangles begin ... end - 1 with the AVX2 kernel (see TriangleKernel.h) if use_simd is true and
+ * the CPU has AVX2 (floats and doubles), otherwise (and for the last triangles) with compute_triangle_geometry_scalar.
  */
-Point3d get_normal_edge(int index_v1, int index_v2)
+template <typename AreaEstimator = MixedVoronoiArea, typename Estimators = AllCurvatureEstimators, typename TriangleType, typename Position, typename Scalar>
+void compute_triangle_geometry(TriangleType *triangles, const Position *x, const Position *y, const Position *z, int begin, int end, const TriangleGeometry<Scalar> &geometry, bool use_simd)
 {
-
-    vector<int> res = get_triangle_by_edge(index_v1, index_v2);
-    int triangle_1 = res[0];
-    int triangle_2 = res[1];
-
-    Point3d v0_t1 = get_rescaled_value(v[t[triangle_1].v[0]]);
-    Point3d v1_t1 = get_rescaled_value(v[t[triangle_1].v[1]]);
-    Point3d v2_t1 = get_rescaled_value(v[t[triangle_1].v[2]]);
-    Point3d n_t1 = (v1_t1 - v0_t1) ^ (v2_t1 - v0_t1);
-    n_t1.normalize();
-
-    Point3d v0_t2 = get_rescaled_value(v[t[triangle_2].v[0]]);
-    Point3d v1_t2 = get_rescaled_value(v[t[triangle_2].v[1]]);
-    Point3d v2_t2 = get_rescaled_value(v[t[triangle_2].v[2]]);
-    Point3d n_t2 = (v1_t2 - v0_t2) ^ (v2_t2 - v0_t2);
-    n_t2.normalize();
-
-    Point3d n_edge = (n_t1 + n_t2);
-    n_edge.normalize();
-    return n_edge;
+#ifdef TRIANGLE_KERNEL_AVX2
+    if (use_simd && is_avx2_supported())
+        begin = compute_triangle_geometry_avx2<AreaEstimator, Estimators>(triangles, x, y, z, begin, end, geometry);
+#endif
+    compute_triangle_geometry_scalar<AreaEstimator, Estimators>(triangles, x, y, z, begin, end, geometry);
 }
 
 /**
- * Function to insert a struct edge inside edge-map.
+ * Geometry of the triangles begin ... end - 1 in long double: always compute_triangle_geometry_scalar, the kernel
+ * computes in double.
  */
-void insert_edge(int index_v1, int index_v2, bool isCorrectOrder, Point3d n, double angle, double area_triangle)
+template <typename AreaEstimator = MixedVoronoiArea, typename Estimators = AllCurvatureEstimators, typename TriangleType, typename Position>
+void compute_triangle_geometry(TriangleType *triangles, const Position *x, const Position *y, const Position *z, int begin, int end, const TriangleGeometry<long double> &geometry, bool)
 {
-    vector<int> key(2);
-    if (isCorrectOrder)
-    {
-        key[0] = index_v1;
-        key[1] = index_v2;
-    }
-    else
+    compute_triangle_geometry_scalar<AreaEstimator, Estimators>(triangles, x, y, z, begin, end, geometry);
+}
+
+/**
+ * Function to read the file.off and fill vectors
+*/
+bool read_off_file(const char *path, vector<Point3d> &out_v, vector<Triangle> &out_t)
+{
+    ifstream in(path);
+    if (!in)
     {
-        key[0] = index_v2;
-        key[1] = index_v1;
+        cout << "\nError reading file." << endl;
+        return false;
     }
 
-    std::map<vector<int>, edge>::iterator it; // iterator
-
-    // convention: from smaller to higher index
-    it = map_edge.find(key);
+    string s;
+    string offName = "OFF";
+    getline(in, s);
 
-    if (it != map_edge.end()) // update information edge struct if exist
+    if (s.compare(0, offName.size(), offName) != 0)
     {
-        if (isCorrectOrder)
-        { // means index_1 < index_2
-            it->second.n1 = n;
-            it->second.cot_alpha = get_cotangent(angle);
-            it->second.area_t1 = area_triangle;
-        }
-        else
-        {
-            it->second.n2 = n;
-            it->second.cot_beta = get_cotangent(angle);
-            it->second.area_t2 = area_triangle;
-        }
+        cout << "This is not a valid OFF file." << endl;
+        return false;
+    }
 
-        // value mean curvature for mean curvature per edge H(E) = ||E|| * sin(theta/2)
-        float value = it->second.norm_edge * ((it->second.n1).getAngle(it->second.n2) / 2.0f);
-        float normalized_value = value / ((it->second.area_t1 + it->second.area_t2) / 3.0f); // divide the value by edge area (1/3 * (area triangles))
+    int i, dummy, vertices_count, triangles_count;
+    in >> vertices_count >> triangles_count >> dummy;
 
-        // create matrix M = [e, n1, n2] with these vectors as columns
-        double M[3][3] = {
-            {(v[it->second.index_v2] - v[it->second.index_v1])[0], it->second.n1[0], it->second.n2[0]},
-            {(v[it->second.index_v2] - v[it->second.index_v1])[1], it->second.n1[1], it->second.n2[1]},
-            {(v[it->second.index_v2] - v[it->second.index_v1])[2], it->second.n1[2], it->second.n2[2]}};
+    out_v.resize(vertices_count);
+    for (i = 0; i < vertices_count; i++)
+        in >> out_v[i][0] >> out_v[i][1] >> out_v[i][2];
 
-        double determinant = M[0][0] * ((M[1][1] * M[2][2]) - (M[2][1] * M[1][2])) - M[0][1] * (M[1][0] * M[2][2] - M[2][0] * M[1][2]) + M[0][2] * (M[1][0] * M[2][1] - M[2][0] * M[1][1]);
+    out_t.resize(triangles_count);
 
-        if (determinant < 0.0) // negative value
-            it->second.value_mean_curvature = (-1) * normalized_value;
-        else
-            it->second.value_mean_curvature = normalized_value;
-    }
-    else
-    {                       // create new edge struct
-        edge e1;            // struct
-        if (isCorrectOrder) // index_v1 < index_v2
+    // polygons are triangulated as a fan, their other triangles are appended after the faces (as parse_off_buffer)
+    vector<Triangle> polygon_triangles;
+    int size;
+    for (i = 0; i < triangles_count; i++)
+    {
+        in >> size >> out_t[i].v[0] >> out_t[i].v[1] >> out_t[i].v[2];
+        Triangle fan = out_t[i];
+        for (int j = 3; j < size && in; j++)
         {
-            // correct order
-            e1.index_v1 = index_v1;
-            e1.index_v2 = index_v2;
-            e1.n1 = n;
-            e1.cot_alpha = get_cotangent(angle);
-            e1.area_t1 = area_triangle;
+            fan.v[1] = fan.v[2];
+            in >> fan.v[2];
+            polygon_triangles.push_back(fan);
         }
-        else
-        { // reverse case
-            e1.index_v1 = index_v2;
-            e1.index_v2 = index_v1;
-            e1.n2 = n;
-            e1.cot_beta = get_cotangent(angle);
-            e1.area_t2 = area_triangle;
+        if (!in || size < 3)
+        {
+            cout << "Invalid face " << i << " in OFF file." << endl;
+            return false;
         }
-
-        e1.norm_edge = (v[e1.index_v2] - v[e1.index_v1]).norm();
-
-        map_edge[key] = e1;
+        in.ignore(numeric_limits<streamsize>::max(), '\n'); // colors
     }
+    out_t.insert(out_t.end(), polygon_triangles.begin(), polygon_triangles.end());
+
+    in.close();
+    return true;
 }
 
 /**
- * Function to get mean curvature edge
+ * Parse the header of an OFF file ("OFF" and the number of vertices, faces and edges) in counts of type Count
+ * (int for the readers of load(), int64_t for the streaming mode). The tokenizer is moved at the beginning of the
+ * line after the counts.
  */
-double get_mean_curvature_edge(int vertex_1, int vertex_2)
+template <typename Count>
+bool parse_off_header(MeshTokenizer &tokenizer, Count &vertices_count, Count &triangles_count)
 {
-    vector<int> current_edge;
-    if (vertex_1 < vertex_2) // correct order
+    const char *token_begin, *token_end;
+    if (!tokenizer.next_token(token_begin, token_end) || token_end - token_begin < 3 || strncmp(token_begin, "OFF", 3) != 0)
     {
-        current_edge = {vertex_1, vertex_2};
+        cout << "This is not a valid OFF file." << endl;
+        return false;
     }
-    else
-        current_edge = {vertex_2, vertex_1}; // reverse order
-
-    std::map<vector<int>, edge>::iterator it; // iterator
-    it = map_edge.find(current_edge);
 
-    if (it != map_edge.end())
+    Count edges_count;
+    if (!tokenizer.next_int(vertices_count) || !tokenizer.next_int(triangles_count) || !tokenizer.next_int(edges_count) || vertices_count < 0 || triangles_count < 0)
     {
-        return it->second.value_mean_curvature;
+        cout << "Invalid OFF header." << endl;
+        return false;
     }
 
-    cout << "Mean curvature per edge not found for edge: " << current_edge[0] << " " << current_edge[1] << endl;
-    exit(-1);
+    tokenizer.skip_line();
+    return true;
 }
 
 /**
-* Update values for mean curvature values per edge/vertex.
-* For each vertex v0, v1, v2 -> for v0 take edge v1v2, v1 for v2v0, v2 for v0v1.
-* Where v0 is the opposite_index of index_1 v1 and index_2 v2 (edge v1v2).
-* Mean curvature per edge: insert to vector vector_mc_sum (length: #vertices) the corresponding value of mean curvature at the vertex opposite to this edge.
-* Mean curvature per vertex: insert to vector mean_curvature_vertex_sum (length: #vertices) the corresponding value of mean curvature at that vertex of the edge.
-*/
-void insert_values_mean_curvature(int index_1, int index_2, int opposite_index)
+ * Parse one vertex (x y z).
+ */
+inline bool parse_off_vertex(MeshTokenizer &tokenizer, Point3d &vertex)
 {
-    std::map<vector<int>, edge>::iterator it; // iterator
-
-    if (index_1 < index_2)
-    { // to avoid to iterate 2 times on the same value (edge are shared between 2 triangles)
-        it = map_edge.find({index_1, index_2});
-
-        if (it != map_edge.end())
-        {
-            // update mean curvature values per edge
-            vector_mc_sum[opposite_index] += it->second.value_mean_curvature;
-
-            // update mean curvature values per vertex
-            mean_curvature_vertex_sum[it->second.index_v2] += (it->second.cot_alpha + it->second.cot_beta) * (v[it->second.index_v2] - v[it->second.index_v1]);
-            mean_curvature_vertex_sum[it->second.index_v1] += (it->second.cot_alpha + it->second.cot_beta) * (v[it->second.index_v1] - v[it->second.index_v2]);
-        }
-        else
-        {
-            cout << "error: edge not found!";
-            exit(-1);
-        }
-    }
-    else
-    { // other case
-        // just update the mean curvature values per edge of other vertex
-        it = map_edge.find({index_2, index_1});
-
-        if (it != map_edge.end())
-        {
-            // update mean curvature values per edge
-            vector_mc_sum[opposite_index] += it->second.value_mean_curvature;
-        }
-        else
-        {
-            cout << "error: edge not found!";
-            exit(-1);
-        }
-    }
+    double x, y, z;
+    if (!tokenizer.next_double(x) || !tokenizer.next_double(y) || !tokenizer.next_double(z))
+        return false;
+    vertex.setCoords(x, y, z);
+    return true;
 }
 
 /**
- * Function to update the minimum and the maximum value found in coords of an object.
+ * Parse one face (size v0 v1 v2 ...), the tokenizer is moved at the end of the line (after the colors).
+ * A polygon is triangulated as a fan around v0: [v0, v1, v2] is written in triangle, the other triangles
+ * [v0, v2, v3], [v0, v3, v4] ... are appended to polygon_triangles.
  */
-void set_min_max(Point3d current)
+inline bool parse_off_face(MeshTokenizer &tokenizer, Triangle &triangle, vector<Triangle> &polygon_triangles)
 {
-    min_coord = fmin(fmin(current.x(), current.y()), fmin(current.z(), min_coord));
-    max_coord = fmax(fmax(current.x(), current.y()), fmax(current.z(), max_coord));
+    int size;
+    if (!tokenizer.next_int(size) || size < 3 || !tokenizer.next_int(triangle.v[0]) || !tokenizer.next_int(triangle.v[1]) || !tokenizer.next_int(triangle.v[2]))
+        return false;
+    Triangle fan = triangle;
+    for (int j = 3; j < size; j++)
+    {
+        fan.v[1] = fan.v[2];
+        if (!tokenizer.next_int(fan.v[2]))
+            return false;
+        polygon_triangles.push_back(fan);
+    }
+    tokenizer.skip_line();
+    return true;
 }
 
 /**
- * Function to set max and min of a mesh
+ * Parse the bytes of an OFF file and fill out_v and out_t.
+ * The faces are the first triangles of out_t, the other triangles of the polygons (see parse_off_face) follow them.
  */
-void set_max_min_mesh()
+bool parse_off_buffer(const char *begin, const char *end, vector<Point3d> &out_v, vector<Triangle> &out_t)
 {
-    // initialize min_coord and max_coord
-    min_coord = fmin(fmin(v[t[0].v[0]].x(), v[t[0].v[0]].y()), v[t[0].v[0]].z());
-    max_coord = fmax(fmax(v[t[0].v[0]].x(), v[t[0].v[0]].y()), v[t[0].v[0]].z());
+    MeshTokenizer tokenizer(begin, end);
+    int vertices_count, triangles_count;
+    if (!parse_off_header(tokenizer, vertices_count, triangles_count))
+        return false;
 
-    // set max and min
-    for (int k = 0; k < num_triangles; k++)
+    out_v.resize(vertices_count);
+    for (int i = 0; i < vertices_count; i++)
     {
-        // Update max and min
-        set_min_max(v[t[k].v[0]]);
-
-        set_min_max(v[t[k].v[1]]);
+        if (!parse_off_vertex(tokenizer, out_v[i]))
+        {
+            cout << "Invalid vertex " << i << " in OFF file." << endl;
+            return false;
+        }
+    }
 
-        set_min_max(v[t[k].v[2]]);
+    out_t.resize(triangles_count);
+    vector<Triangle> polygon_triangles;
+    for (int i = 0; i < triangles_count; i++)
+    {
+        if (!parse_off_face(tokenizer, out_t[i], polygon_triangles))
+        {
+            cout << "Invalid face " << i << " in OFF file." << endl;
+            return false;
+        }
     }
+    out_t.insert(out_t.end(), polygon_triangles.begin(), polygon_triangles.end());
+    return true;
 }
 
 /**
- * Find area of triangle using Heron's formula.
- * s = (a + b + c) / 2
- * A = sqrt(s (s - a) (s - b) (s-c))
-*/
-double get_area_triangle(int index_triangle)
+ * Return true if the line contains a record (it is not empty and it is not a comment).
+ */
+inline bool is_off_record_line(const char *p, const char *line_end)
 {
-    Point3d v0 = get_rescaled_value(v[t[index_triangle].v[0]]);
-    Point3d v1 = get_rescaled_value(v[t[index_triangle].v[1]]);
-    Point3d v2 = get_rescaled_value(v[t[index_triangle].v[2]]);
-
-    double edge0 = get_distance_points(v0, v1);
-    double edge1 = get_distance_points(v0, v2);
-    double edge2 = get_distance_points(v1, v2);
-
-    double s = (edge0 + edge1 + edge2) / 2;
-    return sqrt(s * (s - edge0) * (s - edge1) * (s - edge2));
+    return MeshTokenizer::skip_whitespace(p, line_end) < line_end;
 }
 
 /**
- * Function to get Voronoi region of vertex P in triangle [P, Q, R].
- * See paper http://www.geometry.caltech.edu/pubs/DMSB_III.pdf (section 3.3)
+ * Return the end of the line starting at p (position of its \n or end).
  */
-double get_voronoi_region_triangle(int P_index, int Q_index, int R_index, float Q_angle, float R_angle)
+inline const char *get_off_line_end(const char *p, const char *end)
 {
-    Point3d P = get_rescaled_value(v[P_index]);
-    Point3d Q = get_rescaled_value(v[Q_index]);
-    Point3d R = get_rescaled_value(v[R_index]);
-    double first_part = pow(get_distance_points(P, R), 2) * get_cotangent(Q_angle);
-    double second_part = pow(get_distance_points(P, Q), 2) * get_cotangent(R_angle);
-    return (first_part + second_part) / 8;
+    const char *line_end = (const char *)memchr(p, '\n', end - p);
+    return line_end ? line_end : end;
 }
 
 /**
- * Check if an angle is obtuse (radians)
+ * Count the records (vertices and faces) of a chunk of lines.
  */
-bool is_obtuse_angle(float angle)
+long count_off_records(const char *begin, const char *end)
 {
-    return angle > M_PI / 2 && angle < M_PI;
+    long records = 0;
+    for (const char *p = begin; p < end; p++)
+    {
+        const char *line_end = get_off_line_end(p, end);
+        if (is_off_record_line(p, line_end))
+            records++;
+        p = line_end;
+    }
+    return records;
 }
 
 /**
- * Calculate Area mixed, given the index of the triangle, index of the  vertex and 3 angles of the triangle.
- * This function will be called for each triangle T from the 1-ring neighborhood of x (current angle)
-*/
-void calculate_A_mixed(int index_triangle, int index_vertex, int index_vertex_other, int index_vertex_other1, float current_angle, float other_angle, float other_angle_1)
+ * Parse a chunk of lines whose first record has index first_record: records before vertices_count
+ * are vertices, the next ones are faces (the other triangles of its polygons go to polygon_triangles).
+ * Each line must contain exactly one record.
+ */
+bool parse_off_records(const char *begin, const char *end, long first_record, vector<Point3d> &out_v, vector<Triangle> &out_t, vector<Triangle> &polygon_triangles)
 {
-    if (!is_obtuse_angle(current_angle) && !is_obtuse_angle(other_angle) && !is_obtuse_angle(other_angle_1)) // Triangle is not obtuse -> Voronoi-safe
-    {
-        // Voronoi region of x in T
-        area_mixed[index_vertex] += get_voronoi_region_triangle(index_vertex, index_vertex_other, index_vertex_other1, other_angle, other_angle_1);
-    }
-    else // Voronoi inappropriate
+    long vertices_count = out_v.size();
+    long records_count = vertices_count + out_t.size();
+    long record = first_record;
+
+    for (const char *p = begin; p < end && record < records_count; p++)
     {
-        if (is_obtuse_angle(current_angle)) //obtuse angle
-            area_mixed[index_vertex] += get_area_triangle(index_triangle) / 2;
-        else // not-obtuse triangle
-            area_mixed[index_vertex] += get_area_triangle(index_triangle) / 4;
+        const char *line_end = get_off_line_end(p, end);
+        if (is_off_record_line(p, line_end))
+        {
+            MeshTokenizer tokenizer(p, line_end);
+            if (record < vertices_count)
+            {
+                if (!parse_off_vertex(tokenizer, out_v[record]))
+                    return false;
+            }
+            else if (!parse_off_face(tokenizer, out_t[record - vertices_count], polygon_triangles))
+                return false;
+            record++;
+        }
+        p = line_end;
     }
+    return true;
 }
 
+// number of threads used to load a mesh (0: one thread for each core), default of MeshCurvature::threads
+int loader_threads = 0;
+
+// files smaller than this size are parsed with one thread
+const size_t PARALLEL_PARSING_MIN_BYTES = 1 << 20;
+
 /**
- * Function to clean allocated memory in order to load correctly different meshes.
+ * Parse the bytes of an OFF file with many threads and fill out_v and out_t.
+ * The body of the file is split at line boundaries in one chunk for each thread: a first parallel pass counts
+ * the records of each chunk, so each thread knows the index of its first vertex/face and in a second
+ * parallel pass writes directly into its slice of out_v and out_t (sized with the counts of the header).
+ * Files with more than one record on a line are parsed again with parse_off_buffer.
  */
-void clean()
+bool parse_off_buffer_parallel(const char *begin, const char *end, vector<Point3d> &out_v, vector<Triangle> &out_t, int threads_count, size_t min_bytes = PARALLEL_PARSING_MIN_BYTES)
 {
-    t.clear();
-    t.shrink_to_fit();
-    v.clear();
-    v.shrink_to_fit();
-}
+    threads_count = get_threads_count(threads_count);
+    if (threads_count == 1 || (size_t)(end - begin) < min_bytes)
+        return parse_off_buffer(begin, end, out_v, out_t);
 
-/**
- * Function to read the file.off and fill vectors
-*/
-bool read_off_file(const char *path)
-{
-    ifstream in(path);
-    if (!in)
-    {
-        cout << "\nError reading file." << endl;
+    MeshTokenizer header(begin, end);
+    int vertices_count, triangles_count;
+    if (!parse_off_header(header, vertices_count, triangles_count))
         return false;
-    }
-
-    string s;
-    string offName = "OFF";
-    getline(in, s);
+    const char *body = header.position();
 
-    if (s.compare(0, offName.size(), offName) != 0)
+    // split the body in chunks at line boundaries
+    vector<const char *> chunks(threads_count + 1);
+    chunks[0] = body;
+    for (int i = 1; i < threads_count; i++)
     {
-        cout << "This is not a valid OFF file." << endl;
-        return false;
+        const char *p = max(chunks[i - 1], body + (end - body) * i / threads_count);
+        p = get_off_line_end(p, end);
+        chunks[i] = p < end ? p + 1 : end;
     }
-
-    int i, dummy;
-    in >> num_vertices >> num_triangles >> dummy;
-
-    v.resize(num_vertices);
-    for (i = 0; i < num_vertices; i++)
-        in >> v[i][0] >> v[i][1] >> v[i][2];
-
-    t.resize(num_triangles);
-
-    for (i = 0; i < num_triangles; i++)
-        in >> dummy >> t[i].v[0] >> t[i].v[1] >> t[i].v[2];
-
-    in.close();
+    chunks[threads_count] = end;
+
+    // first pass: count records of each chunk
+    vector<long> first_record(threads_count + 1, 0);
+    vector<thread> workers;
+    for (int i = 0; i < threads_count; i++)
+        workers.push_back(thread([&, i]() { first_record[i + 1] = count_off_records(chunks[i], chunks[i + 1]); }));
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+    workers.clear();
+
+    for (int i = 1; i <= threads_count; i++)
+        first_record[i] += first_record[i - 1];
+
+    if (first_record[threads_count] < (long)vertices_count + triangles_count)
+        return parse_off_buffer(begin, end, out_v, out_t); // records are not one per line
+
+    // second pass: parse each chunk into its slice of out_v and out_t
+    out_v.resize(vertices_count);
+    out_t.resize(triangles_count);
+    vector<char> is_parsed(threads_count, 0);
+    vector<vector<Triangle> > polygon_triangles(threads_count);
+    for (int i = 0; i < threads_count; i++)
+        workers.push_back(thread([&, i]() { is_parsed[i] = parse_off_records(chunks[i], chunks[i + 1], first_record[i], out_v, out_t, polygon_triangles[i]); }));
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+
+    for (int i = 0; i < threads_count; i++)
+        if (!is_parsed[i])
+            return parse_off_buffer(begin, end, out_v, out_t);
+    for (int i = 0; i < threads_count; i++) // in the order of the faces, as parse_off_buffer
+        out_t.insert(out_t.end(), polygon_triangles[i].begin(), polygon_triangles[i].end());
     return true;
 }
 
+enum MeshFormat
+{
+    MESH_OFF,
+    MESH_PLY,
+    MESH_OBJ
+};
+
 /**
- * Function to load the mesh, find Gaussian Curvature, Mean Curvature...etc.
-*/
-bool load(const char *path, vector<float> &out_vertices, vector<float> &out_normals, vector<float> &out_normals_triangle, vector<float> &out_gc, vector<float> &out_mc, vector<float> &out_mc_vertex, vector<float> &gc_vertex_size, vector<float> &mc_triangle_size_edge, vector<float> &mc_vertex_size_vertex)
+ * Find the format of a mesh file from its first bytes ("OFF", "ply"), or from the extension for OBJ files.
+ */
+MeshFormat get_mesh_format(const char *path, const char *begin, const char *end)
 {
-    // --------------------- Read file -----------------------------
-    if (!read_off_file(path))
-        return false;
+    if (end - begin >= 3 && strncmp(begin, "ply", 3) == 0)
+        return MESH_PLY;
+    if (end - begin >= 3 && strncmp(begin, "OFF", 3) == 0)
+        return MESH_OFF;
+
+    size_t length = strlen(path);
+    if (length >= 4 && (strcmp(path + length - 4, ".obj") == 0 || strcmp(path + length - 4, ".OBJ") == 0))
+        return MESH_OBJ;
+    return MESH_OFF; // the OFF parser reports the error
+}
 
-    // size out_vertices, out_normals, out_gc, out_mc = num_triangles * 9
-
-    // number_obtuse_triangle = 0;
-    // number_non_obtuse_triangle = 0;
-
-    // ------- VECTOR INITIALIZATION -------
-    // vector that contains Point3d normal
-    vector<Point3d> normals(num_vertices);
-    std::fill(normals.begin(), normals.end(), Point3d(0.0f, 0.0f, 0.0f));
-
-    vector<int> v_counter(num_vertices);              // vector to count faces for each vertex to calculate normals
-    std::fill(v_counter.begin(), v_counter.end(), 0); // initialize every vertex normal to (0,0,0)
-
-    vector_mc_sum.resize(num_vertices);
-    std::fill(vector_mc_sum.begin(), vector_mc_sum.end(), 0.0f);
-
-    mean_curvature_vertex_sum.resize(num_vertices);
-    std::fill(mean_curvature_vertex_sum.begin(), mean_curvature_vertex_sum.end(), Point3d(0.0f, 0.0f, 0.0f));
-    // ----
+// ----- DEFAULT SETTINGS OF MeshCurvature (copied when an engine is created) -----
+// if true meshes are read from their binary cache (path + ".meshcache"), written the first time a mesh is parsed
+bool use_mesh_cache = true;
 
-    // -- initialize Gaussian curvature vectors --
-    // vector containing all triangle gaussian value for each vertex
-    // for compatibility values are saved 3 times for each vertex
-    vector<float> value_angle_defeact_sum(num_vertices); // vector containing current sum of partial gaussian curvature per vertex
-    std::fill(value_angle_defeact_sum.begin(), value_angle_defeact_sum.end(), 0);
+// if true coincident vertices are merged after reading (triangle soups), see VertexWelding.h
+bool use_vertex_welding = false;
+double welding_tolerance = 0.0; // maximum distance on each axis of two welded vertices (0: same coordinates)
 
-    area_mixed.resize(num_vertices); // vector containing area_mixed (obtuse and not-obtuse triangle)
-    std::fill(area_mixed.begin(), area_mixed.end(), 0);
-    // ---- end Gaussian curvature vectors initialization ----
+// if true vertices and triangles are reordered for cache locality after reading, see MeshReorder.h
+// (values per vertex are in the new vertex order, values per triangle in the new triangle order)
+bool use_mesh_reordering = false;
 
-    set_max_min_mesh(); // find min value and max value of a mesh (in order to rescale values correctly)
+// if true the geometry of the triangles is computed 4 triangles at a time with AVX2 when the CPU has it, see TriangleKernel.h
+bool use_simd_kernel = true;
 
-    // iterate inside triangles and calculates angle_defeact
-    for (int k = 0; k < num_triangles; k++)
-    {
-        Point3d v0 = get_rescaled_value(v[t[k].v[0]]);
-        Point3d v1 = get_rescaled_value(v[t[k].v[1]]);
-        Point3d v2 = get_rescaled_value(v[t[k].v[2]]);
+// if true load() keeps the edges and their mean curvatures, so update_vertices can update the curvatures around moved vertices
+bool use_incremental_updates = false;
+// -------------------------
 
-        // -- normals ---
-        // for every triangle face compute face normal and normalize it
-        Point3d n = (v1 - v0) ^ (v2 - v0);
-        n.normalize();
-        t[k].n = n;
+enum CurvaturePrecision
+{
+    PRECISION_FLOAT,
+    PRECISION_DOUBLE,
+    PRECISION_LONG_DOUBLE
+};
+
+// ----- DEFAULT PRECISION (instantiation of BasicMeshCurvature used by Object, see visit_mesh_curvature) -----
+CurvaturePrecision curvature_precision = PRECISION_DOUBLE;    // geometry of the triangles and edges
+CurvaturePrecision accumulation_precision = PRECISION_DOUBLE; // values summed per edge and per vertex
+bool use_float_positions = true;                              // positions stored in float, else in the precision of the geometry
+// -------------------------
 
-        // add value to normals vector at the vector
-        normals[t[k].v[0]] += n;
-        normals[t[k].v[1]] += n;
-        normals[t[k].v[2]] += n;
+const char *precision_names[] = {"float", "double", "long_double"};
 
-        v_counter[t[k].v[0]]++; // update counter for normals
-        v_counter[t[k].v[1]]++; // update counter for normals
-        v_counter[t[k].v[2]]++; // update counter for normals
+/**
+ * Find a precision from its name (float, double or long_double). Return false if the name is not one of them.
+ */
+bool get_curvature_precision(const char *name, CurvaturePrecision &precision)
+{
+    for (int i = 0; i < 3; i++)
+        if (strcmp(name, precision_names[i]) == 0)
+        {
+            precision = (CurvaturePrecision)i;
+            return true;
+        }
+    cout << "Unknown precision " << name << " (float, double or long_double)" << endl;
+    return false;
+}
 
-        // fill map edges
-        int index_v0 = t[k].v[0];
-        int index_v1 = t[k].v[1];
-        int index_v2 = t[k].v[2];
-        // -------------- GAUSSIAN CURVATURE --------------
-        // calculate angle defeact for each vertex of triangle
-        // vertex 1
-        // v1 -> v0 -> v2
-        Point3d v0v1 = v1 - v0;
-        Point3d v0v2 = v2 - v0;
-        v0v1.normalize();
-        v0v2.normalize();
-        double angle_v1v0v2 = v0v1.getAngle(v0v2);
+/**
+ * Values changed by BasicMeshCurvature::update_vertices, each list in increasing order: the outputs per triangle
+ * (9 floats at 9 * triangle, 3 at 3 * triangle for the mean curvature per edge) of the triangles, the outputs per vertex
+ * of the vertices and the mean curvature of the edges.
+ */
+struct CurvatureUpdate
+{
+    vector<int> triangles;
+    vector<int> vertices;
+    vector<int> edges;
+};
 
-        // vertex 2
-        // v2 -> v1 -> v0
-        Point3d v1v2 = v2 - v1;
-        v1v2.normalize();
-        double angle_v2v1v0 = v1v2.getAngle(-v0v1); // -v0v1 = v1v0
+// an update computes every curvature again (passes of load) when its triangles are more than 1 / INCREMENTAL_UPDATE_MAX_PART of the mesh
+const int INCREMENTAL_UPDATE_MAX_PART = 4;
 
-        // vertex 3
-        // v0 -> v2 -> v1
-        double angle_v0v2v1 = (-v0v2).getAngle(-v1v2); // same as v0v2.getAngle(v1v2)
+// gap between two changed triangles below which their ranges are merged (see get_index_ranges)
+const int UPDATE_RANGE_MAX_GAP = 16;
 
-        // for each vertex of the triangle updated its value of gc (sum_(j=1)^(#faces around this vertex) vertex_j)
-        value_angle_defeact_sum[t[k].v[0]] += angle_v1v0v2;
-        value_angle_defeact_sum[t[k].v[1]] += angle_v2v1v0;
-        value_angle_defeact_sum[t[k].v[2]] += angle_v0v2v1;
+/**
+ * Ranges [first, last + 1) of the sorted indices: indices closer than max_gap + 1 are in the same range, so a few
+ * unchanged items are copied again instead of starting a new range.
+ */
+inline void get_index_ranges(const vector<int> &indices, int max_gap, vector<pair<int, int> > &ranges)
+{
+    ranges.clear();
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        if (ranges.empty() || indices[i] - ranges.back().second > max_gap)
+            ranges.push_back(make_pair(indices[i], indices[i] + 1));
+        else
+            ranges.back().second = indices[i] + 1;
+    }
+}
 
-        // find A_mixed (obtuse and not obtuse triangle)
-        calculate_A_mixed(k, index_v0, index_v1, index_v2, angle_v1v0v2, angle_v2v1v0, angle_v0v2v1);
-        calculate_A_mixed(k, index_v1, index_v0, index_v2, angle_v2v1v0, angle_v1v0v2, angle_v0v2v1);
-        calculate_A_mixed(k, index_v2, index_v0, index_v1, angle_v0v2v1, angle_v1v0v2, angle_v2v1v0);
+/**
+ * Curvature engine: load() reads a mesh and computes its normals and curvatures.
+ * The mesh, its connectivity, the values per edge and per vertex and the settings are members, nothing is global:
+ * several engines can load different meshes at the same time on different threads.
+ * The settings are copied from the defaults above when the engine is created. progress (if not NULL) receives the
+ * progress of load() between 0 and 1, it can be read by other threads (see ObjectLoader.h).
+ * Scalar is the precision of the geometry of the triangles and of the edges (normals, angles, cotangents, areas,
+ * dihedral angles), Accumulator the precision of the values summed per edge and per vertex (angle defect, Area mixed,
+ * mean curvatures, normals of the vertices) and Position the precision of the stored positions (float: half the memory,
+ * the positions are widened to Scalar when they are read). The outputs are floats whatever the precision.
+ * AreaEstimator is the area of the vertices and Estimators the set of curvatures computed (see CurvatureEstimators.h):
+ * the outputs of the curvatures not in the set are 0.
+ */
+template <typename Scalar, typename Accumulator, typename AreaEstimator = MixedVoronoiArea, typename Estimators = AllCurvatureEstimators, typename Position = Scalar>
+class BasicMeshCurvature
+{
+  public:
+    typedef Scalar scalar_type;           // precisions of the engine (used by load_streaming, see StreamingCurvature.h)
+    typedef Accumulator accumulator_type;
+    typedef Position position_type;
+
+    // ----- SET UP DATA AND VERTICES -----
+    vector<Point3d> v; // vector of vertices, as read (released by load() once positions is built)
+    vector<Triangle> t; // vector of triangles
+
+    // positions of the vertices rescaled between -1 and 1 (see VertexPositions.h), built by load()
+    VertexPositions<Position> positions;
+
+    // vertex -> triangles and vertex -> vertices of t (see VertexAdjacency.h), valid with v and t
+    VertexAdjacency vertex_adjacency;
+
+    int num_triangles = 0; // number of triangles in the mesh
+    int num_vertices = 0;  // number of vertices in the mesh
+
+    // with use_mesh_reordering, index in v and t of each vertex and of each triangle of the mesh as read (after
+    // welding), empty otherwise (see get_vertex_index): the outputs of load() and the vertices of update_vertices are
+    // in the reordered numbering
+    vector<int> vertex_index;
+    vector<int> triangle_index;
+    // -------------------------
+
+    // ----- CROP DATA BETWEEN [-1, 1] -----
+    // minimum and maximum value found in the mesh
+    double min_coord = 0.0f;
+    double max_coord = 0.0f;
+    // -------------------------
+
+    // ----- MEAN CURVATURE -----
+    // edges of the mesh with their incidences (see MeshEdges.h)
+    MeshEdges mesh_edges;
+
+    // mean curvature per edge H(E), normalized by the edge area, parallel to mesh_edges.edge_v1 and mesh_edges.edge_v2
+    vector<Accumulator> edge_mean_curvature;
+    // -------------------------
+
+    // ----- INCREMENTAL UPDATES (see update_vertices) -----
+    // slot of each triangle and vertex in the current update (-1 if it is not in it) and edges in it, sized by load()
+    // with use_incremental_updates, reset after each update
+    vector<int> triangle_update_slot;
+    vector<int> vertex_update_slot;
+    vector<char> is_edge_in_update;
+    // -------------------------
+
+    // ----- SETTINGS -----
+    bool use_mesh_cache;
+    bool use_vertex_welding;
+    double welding_tolerance;
+    bool use_mesh_reordering;
+    bool use_simd_kernel;
+    bool use_incremental_updates;
+    int threads; // number of threads used to parse a file and to compute the curvatures (0: one thread for each core)
+    // -------------------------
+
+    atomic<float> *progress;
+
+    BasicMeshCurvature(atomic<float> *progress = NULL)
+        : use_mesh_cache(::use_mesh_cache), use_vertex_welding(::use_vertex_welding), welding_tolerance(::welding_tolerance),
+          use_mesh_reordering(::use_mesh_reordering), use_simd_kernel(::use_simd_kernel),
+          use_incremental_updates(::use_incremental_updates), threads(loader_threads), progress(progress) {}
+
+    /**
+     * Function to clean allocated memory in order to load correctly different meshes.
+     */
+    void clean()
+    {
+        t.clear();
+        t.shrink_to_fit();
+        v.clear();
+        v.shrink_to_fit();
+        positions.clear();
+        vertex_adjacency.clear();
+        vector<int>().swap(vertex_index);
+        vector<int>().swap(triangle_index);
+        vector<int>().swap(triangle_update_slot);
+        vector<int>().swap(vertex_update_slot);
+        vector<char>().swap(is_edge_in_update);
+    }
 
-        // if (!is_obtuse_angle(angle_v1v0v2) && !is_obtuse_angle(angle_v2v1v0) && !is_obtuse_angle(angle_v0v2v1)) // Triangle is not obtuse
-        //     number_non_obtuse_triangle++;
-        // else // triangle obtuse
-        //     number_obtuse_triangle++;
+    /**
+     * Function to read a mesh file (OFF, PLY or OBJ, found by get_mesh_format) and fill vectors.
+     */
+    bool read_mesh_file(const char *path)
+    {
+        MappedFile file;
+        if (!file.open(path))
+        {
+            cout << "\nError reading file." << endl;
+            return false;
+        }
 
-        // -------------- MEAN CURVATURE EDGE --------------
-        float area_triangle = get_area_triangle(k);
+        bool is_read;
+        switch (get_mesh_format(path, file.begin(), file.end()))
+        {
+        case MESH_PLY:
+            is_read = parse_ply_buffer(file.begin(), file.end(), v, t);
+            break;
+        case MESH_OBJ:
+            is_read = parse_obj_buffer(file.begin(), file.end(), v, t);
+            break;
+        default:
+            is_read = parse_off_buffer_parallel(file.begin(), file.end(), v, t, threads);
+            break;
+        }
+        if (!is_read)
+            return false;
 
-        bool isCorrectedOrder = false;
+        num_vertices = v.size();
+        num_triangles = t.size();
+        return true;
+    }
 
-        if (index_v0 < index_v1)
-            isCorrectedOrder = true;
+    /**
+     * Function to read a mesh: from its binary cache if it is up to date, otherwise from the mesh file (then the cache is written).
+     * The cache contains the mesh as it is in the file, welding is done after.
+     * Return false if the mesh has no triangles or an invalid vertex index (checked before welding and reordering,
+     * which index arrays by vertex).
+     */
+    bool read_mesh(const char *path)
+    {
+        if (!(use_mesh_cache && read_mesh_cache(path, v, t)))
+        {
+            if (!read_mesh_file(path))
+                return false;
 
-        // angle is v1v2v0
-        // angle_v0v2v1
-        // edge v0v1
-        insert_edge(index_v0, index_v1, isCorrectedOrder, n, angle_v0v2v1, area_triangle);
+            if (use_mesh_cache && !write_mesh_cache(path, v, t))
+                cout << "Mesh cache not written for " << path << endl;
+        }
 
-        isCorrectedOrder = false;
+        if (t.empty())
+        {
+            cout << "The mesh has no faces." << endl;
+            return false;
+        }
+        if (!check_triangle_indices(t, v.size()))
+            return false;
 
-        if (index_v2 < index_v0)
-            isCorrectedOrder = true;
+        if (use_vertex_welding)
+        {
+            size_t vertices_count = v.size();
+            int removed_triangles = weld_vertices(v, t, welding_tolerance);
+            cout << "Welded " << vertices_count << " vertices into " << v.size() << " (" << removed_triangles << " degenerate triangles removed)" << endl;
+        }
 
-        // angle is v0v1v2
-        // edge v2v0
-        insert_edge(index_v2, index_v0, isCorrectedOrder, n, angle_v2v1v0, area_triangle);
+        if (use_mesh_reordering)
+        {
+            ReorderStatistics statistics = reorder_mesh(v, t, &vertex_index, &triangle_index);
+            cout << "Reordered mesh, ACMR (FIFO " << reorder_cache_size << "): " << statistics.acmr_before << " -> " << statistics.acmr_after
+                 << ", cache misses: " << statistics.cache_misses_before << " -> " << statistics.cache_misses_after << endl;
+        }
+        else
+        {
+            vector<int>().swap(vertex_index);
+            vector<int>().swap(triangle_index);
+        }
 
-        isCorrectedOrder = false;
+        num_vertices = v.size();
+        num_triangles = t.size();
+        return true;
+    }
 
-        if (index_v1 < index_v2)
-            isCorrectedOrder = true;
+    /**
+     * Index in v and t (and in the outputs of load()) of a vertex or a triangle of the mesh as read, after welding.
+     */
+    int get_vertex_index(int file_vertex) const
+    {
+        return vertex_index.empty() ? file_vertex : vertex_index[file_vertex];
+    }
 
-        // angle is v2v0v1
-        // edge v1v2
-        insert_edge(index_v1, index_v2, isCorrectedOrder, n, angle_v1v0v2, area_triangle);
-        // -------------- end mean curvature edge --------------
+    int get_triangle_index(int file_triangle) const
+    {
+        return triangle_index.empty() ? file_triangle : triangle_index[file_triangle];
     }
 
-    // normals
-    // normalize every vertex normal
-    // average of norms of adj triangle of a vertex (sum of triangle norms / number of triangles)
-    for (int k = 0; k < num_vertices; k++)
+    /**
+     * Key of the settings that change the results of load() (part of the key of the curvature cache).
+     */
+    uint64_t get_settings_key()
     {
-        if (v_counter[k] != 0)
+        uint64_t key = 0;
+        if (use_vertex_welding)
         {
-            normals[k] = normals[k] / v_counter[k];
+            uint64_t tolerance_bits;
+            memcpy(&tolerance_bits, &welding_tolerance, sizeof(tolerance_bits));
+            key ^= (tolerance_bits + 1) * 0x9E3779B97F4A7C15ULL;
         }
-        normals[k].normalize();
+        if (use_mesh_reordering)
+            key ^= 0xD1B54A32D192ED03ULL;
+        if (use_simd_kernel && is_avx2_supported() && sizeof(Scalar) <= sizeof(double)) // angles differ by a few ulps
+            key ^= 0x8CB92BA72F3D8DD7ULL;
+        key ^= (sizeof(Position) * 1024 + sizeof(Scalar) * 32 + sizeof(Accumulator)) * 0xC2B2AE3D27D4EB4FULL;
+        key ^= (AreaEstimator::id * 8 + Estimators::missing_flags) * 0x165667B19E3779F9ULL;
+        return key;
     }
 
-    // fill out_gc vector
-    // k_G = (2PI - sum_angle_defeact)/A_mixed
-    for (int k = 0; k < num_triangles; k++)
+    /**
+     * Function to rescale a coord of the mesh such that the coords is in a range between -1 and 1.
+     */
+    Point3d get_rescaled_value(Point3d value)
     {
-        // vertex 0
-        float current_gc = ((2 * M_PI) - value_angle_defeact_sum[t[k].v[0]]) / area_mixed[t[k].v[0]];
-        out_gc.push_back(current_gc);
-        out_gc.push_back(current_gc);
-        out_gc.push_back(current_gc);
-
-        // vertex 1
-        current_gc = ((2 * M_PI) - value_angle_defeact_sum[t[k].v[1]]) / area_mixed[t[k].v[1]];
-        out_gc.push_back(current_gc);
-        out_gc.push_back(current_gc);
-        out_gc.push_back(current_gc);
-
-        // vertex 2
-        current_gc = ((2 * M_PI) - value_angle_defeact_sum[t[k].v[2]]) / area_mixed[t[k].v[2]];
-        out_gc.push_back(current_gc);
-        out_gc.push_back(current_gc);
-        out_gc.push_back(current_gc);
+        return ::get_rescaled_value(value, min_coord, max_coord);
+    }
 
-        // -------------- end Gaussian curvature --------------
+    /**
+     * Length in the coords of the file of a length 1 in the rescaled coords (the edge vectors of the mean curvature
+     * are in the coords of the file).
+     */
+    double get_file_scale()
+    {
+        return (max_coord - min_coord) / interval;
+    }
 
-        // -------------- CALCULATE MEAN CURVATURE --------------
+    /**
+     * Function to update min_coord and max_coord with a coord of the mesh.
+     */
+    void set_min_max(Point3d current)
+    {
+        ::set_min_max(current, min_coord, max_coord);
+    }
 
-        // for each vertex v0, v1, v2 -> for v0 take edge v1v2, v1 for v2v0, v2 for v0v1
+    /**
+     * Function to set max and min of a mesh
+     */
+    void set_max_min_mesh()
+    {
+        // initialize min_coord and max_coord
+        min_coord = fmin(fmin(v[t[0].v[0]].x(), v[t[0].v[0]].y()), v[t[0].v[0]].z());
+        max_coord = fmax(fmax(v[t[0].v[0]].x(), v[t[0].v[0]].y()), v[t[0].v[0]].z());
 
-        // case vertex v0
-        // insert value of edge v1v2
-        // insert_values_mean_curvature(int index_1, int index_2, int opposite_index);
-        insert_values_mean_curvature(t[k].v[1], t[k].v[2], t[k].v[0]);
+        // set max and min
+        for (int k = 0; k < num_triangles; k++)
+        {
+            // Update max and min
+            set_min_max(v[t[k].v[0]]);
 
-        // case vertex v1
-        // insert value of edge v2v0
-        insert_values_mean_curvature(t[k].v[2], t[k].v[0], t[k].v[1]);
+            set_min_max(v[t[k].v[1]]);
 
-        // case vertex v2
-        // insert value of edge v0v1
-        insert_values_mean_curvature(t[k].v[0], t[k].v[1], t[k].v[2]);
-        // -------------- end mean curvature --------------
+            set_min_max(v[t[k].v[2]]);
+        }
     }
 
-    // output vectors
-    //For each vertex of each triangle
-    for (unsigned int k = 0; k < num_triangles; k++)
+    /**
+     * Function to return the index of 2 triangles that share the same edge. index_v1 and index_v2 represent the endpoint of an edge.
+     * The triangles are found among those around index_v1 in vertex_adjacency (O(valence), kept after load() whether
+     * or not the edges are), in increasing order. A missing triangle is -1 (boundary edge); both are -1 if there is
+     * no such edge or if it is shared by more than 2 triangles.
+     */
+    vector<int> get_triangle_by_edge(int index_v1, int index_v2)
     {
-        // Mean curvature per vertex
-        // vertex 0
-        float current_mean_curvature_value = (((1.0f / (2 * area_mixed[t[k].v[0]])) * mean_curvature_vertex_sum[t[k].v[0]]).norm()) / 2.0f;
-
-        if (mean_curvature_vertex_sum[t[k].v[0]] * normals[t[k].v[0]] < 0)
-            current_mean_curvature_value = (-1) * current_mean_curvature_value;
-
-        out_mc_vertex.push_back(current_mean_curvature_value);
-        out_mc_vertex.push_back(current_mean_curvature_value);
-        out_mc_vertex.push_back(current_mean_curvature_value);
-
-        // vertex 1
-        current_mean_curvature_value = (((1.0f / (2 * area_mixed[t[k].v[1]])) * mean_curvature_vertex_sum[t[k].v[1]]).norm()) / 2.0f;
+        vector<int> res;
+        if (index_v1 < 0 || index_v1 >= (int)vertex_adjacency.corners_begin.size() - 1 || index_v1 == index_v2)
+            return {-1, -1};
+        for (int i = vertex_adjacency.corners_begin[index_v1]; i < vertex_adjacency.corners_begin[index_v1 + 1]; i++)
+        {
+            int k = vertex_adjacency.corners[i] / 3;
+            if (t[k].v[0] == index_v2 || t[k].v[1] == index_v2 || t[k].v[2] == index_v2)
+                res.push_back(k);
+        }
 
-        if (mean_curvature_vertex_sum[t[k].v[1]] * normals[t[k].v[1]] < 0)
-            current_mean_curvature_value = (-1) * current_mean_curvature_value;
+        if (res.size() > 2)
+        {
+            cout << "ERROR EDGE SHARED BETWEEN MORE THAN 2 TRIANGLES" << endl;
+            return {-1, -1};
+        }
+        res.resize(2, -1);
+        return res;
+    }
 
-        out_mc_vertex.push_back(current_mean_curvature_value);
-        out_mc_vertex.push_back(current_mean_curvature_value);
-        out_mc_vertex.push_back(current_mean_curvature_value);
+    /**
+     * Return the normal of an edge given 2 endpoints of an edge (the normal of its triangle on the boundary, 0 if the
+     * edge is not found, see get_triangle_by_edge)
+     */
+    Point3d get_normal_edge(int index_v1, int index_v2)
+    {
+        vector<int> res = get_triangle_by_edge(index_v1, index_v2);
+        if (res[0] < 0)
+            return Point3d(0, 0, 0);
+        int triangle_1 = res[0];
+        int triangle_2 = res[1] < 0 ? res[0] : res[1];
+
+        Point3<Scalar> v0_t1(positions.get(t[triangle_1].v[0]));
+        Point3<Scalar> v1_t1(positions.get(t[triangle_1].v[1]));
+        Point3<Scalar> v2_t1(positions.get(t[triangle_1].v[2]));
+        Point3<Scalar> n_t1 = (v1_t1 - v0_t1) ^ (v2_t1 - v0_t1);
+        n_t1.normalize();
+
+        Point3<Scalar> v0_t2(positions.get(t[triangle_2].v[0]));
+        Point3<Scalar> v1_t2(positions.get(t[triangle_2].v[1]));
+        Point3<Scalar> v2_t2(positions.get(t[triangle_2].v[2]));
+        Point3<Scalar> n_t2 = (v1_t2 - v0_t2) ^ (v2_t2 - v0_t2);
+        n_t2.normalize();
+
+        Point3<Scalar> n_edge = (n_t1 + n_t2);
+        n_edge.normalize();
+        return Point3d(n_edge);
+    }
 
-        // vertex 2
-        current_mean_curvature_value = (((1.0f / (2 * area_mixed[t[k].v[2]])) * mean_curvature_vertex_sum[t[k].v[2]]).norm()) / 2.0f;
+    /**
+     * Mean curvature of an edge, given the areas of its triangles at triangle_area[triangle_slot(triangle)]
+     * (triangle_slot(k) = k for the areas of the whole mesh). The 2 triangles of the edge are found through its sides,
+     * in order: n1, area_t1 come from the triangle where the edge goes from the smaller to the bigger index, n2, area_t2
+     * from the other one (0 for a boundary edge).
+     */
+    template <typename TriangleSlot>
+    Accumulator get_edge_mean_curvature(int e, const Scalar *triangle_area, TriangleSlot triangle_slot, double file_scale)
+    {
+        if (mesh_edges.sides_begin[e + 1] - mesh_edges.sides_begin[e] < 2) // boundary edge
+            return 0;
 
-        if (mean_curvature_vertex_sum[t[k].v[2]] * normals[t[k].v[2]] < 0)
-            current_mean_curvature_value = (-1) * current_mean_curvature_value;
+        int index_v1 = mesh_edges.edge_v1[e];
+        int index_v2 = mesh_edges.edge_v2[e];
+        Point3<Scalar> n1, n2;
+        Accumulator area_t1 = 0.0f, area_t2 = 0.0f;
 
-        out_mc_vertex.push_back(current_mean_curvature_value);
-        out_mc_vertex.push_back(current_mean_curvature_value);
-        out_mc_vertex.push_back(current_mean_curvature_value);
+        for (int i = mesh_edges.sides_begin[e]; i < mesh_edges.sides_begin[e + 1]; i++)
+        {
+            int corner = mesh_edges.sides[i];
+            int k = corner / 3;
+            int c = corner % 3;
+            if (t[k].v[(c + 1) % 3] < t[k].v[(c + 2) % 3]) // correct order: index_v1 -> index_v2 in this triangle
+            {
+                n1 = Point3<Scalar>(t[k].n);
+                area_t1 = triangle_area[triangle_slot(k)];
+            }
+            else
+            {
+                n2 = Point3<Scalar>(t[k].n);
+                area_t2 = triangle_area[triangle_slot(k)];
+            }
+        }
 
-        // -------------- end mean curvature per vertex --------------
+        // value mean curvature for mean curvature per edge H(E) = ||E|| * sin(theta/2), ||E|| in the coords of the file
+        Point3<Scalar> edge_vector = (Point3<Scalar>(positions.get(index_v2)) - Point3<Scalar>(positions.get(index_v1))) * file_scale;
+        Accumulator norm_edge = edge_vector.norm();
+        Accumulator value = norm_edge * (n1.getAngle(n2) / 2.0f);
+        Accumulator normalized_value = value / ((area_t1 + area_t2) / 3.0f); // divide the value by edge area (1/3 * (area triangles))
 
-        // insert vertices values in out_vertices
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[0]]).x());
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[0]]).y());
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[0]]).z());
+        // create matrix M = [e, n1, n2] with these vectors as columns
+        Scalar M[3][3] = {
+            {edge_vector[0], n1[0], n2[0]},
+            {edge_vector[1], n1[1], n2[1]},
+            {edge_vector[2], n1[2], n2[2]}};
 
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[1]]).x());
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[1]]).y());
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[1]]).z());
+        Scalar determinant = M[0][0] * ((M[1][1] * M[2][2]) - (M[2][1] * M[1][2])) - M[0][1] * (M[1][0] * M[2][2] - M[2][0] * M[1][2]) + M[0][2] * (M[1][0] * M[2][1] - M[2][0] * M[1][1]);
 
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[2]]).x());
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[2]]).y());
-        out_vertices.push_back(get_rescaled_value(v[t[k].v[2]]).z());
+        if (determinant < 0.0) // negative value
+            return (-1) * normalized_value;
+        return normalized_value;
+    }
 
-        // insert normals in out_normals
-        out_normals.push_back(normals[t[k].v[0]].x());
-        out_normals.push_back(normals[t[k].v[0]].y());
-        out_normals.push_back(normals[t[k].v[0]].z());
+    /**
+     * Function to compute the mean curvature of every edge, given the area of every triangle (edge-centric pass: nothing
+     * is written per triangle or per vertex).
+     */
+    void compute_edge_mean_curvature(const vector<Scalar> &triangle_area)
+    {
+        int edges_count = mesh_edges.edges_count();
+        double file_scale = get_file_scale();
+        edge_mean_curvature.resize(edges_count);
+
+        parallel_for(edges_count, threads, [&](int begin, int end) {
+            for (int e = begin; e < end; e++)
+                edge_mean_curvature[e] = get_edge_mean_curvature(e, triangle_area.data(), [](int k) { return k; }, file_scale);
+        });
+    }
 
-        out_normals.push_back(normals[t[k].v[1]].x());
-        out_normals.push_back(normals[t[k].v[1]].y());
-        out_normals.push_back(normals[t[k].v[1]].z());
+    /**
+     * Function to compute the values of a vertex, gathered from the corners around it (in triangle order): normal (average
+     * of the normals of its triangles, normalized), Gaussian curvature (angle defect) and mean curvature (cotangent
+     * Laplacian), as floats. The values of corner c of triangle k are at 3 * triangle_slot(k) + c in corner_angle and
+     * corner_area_mixed, x, y, z at 3 times that in corner_laplacian (triangle_slot(k) = k for the whole mesh).
+     * If principal_curvatures is not NULL, also k1, k2 and their directions (see PrincipalCurvatures.h): the shape
+     * operator is fitted to the edges of the corners, weighted by half the part of the area of the vertex in their triangle.
+     */
+    template <typename TriangleSlot>
+    void compute_vertex_values(int k, const Scalar *corner_angle, const Scalar *corner_area_mixed, const Scalar *corner_laplacian, TriangleSlot triangle_slot, double file_scale, float vertex_normal[3], float &gc, float &mc,
+                               float *principal_curvatures = NULL, float *principal_directions = NULL)
+    {
+        Point3<Accumulator> normal(0.0f, 0.0f, 0.0f);
+        Accumulator angle_defeact_sum = 0; // sum of partial gaussian curvature
+        Accumulator area_mixed = 0;        // Area mixed (obtuse and not-obtuse triangle)
+        Point3<Accumulator> mc_vertex_sum(0.0f, 0.0f, 0.0f);
+        for (int i = vertex_adjacency.corners_begin[k]; i < vertex_adjacency.corners_begin[k + 1]; i++)
+        {
+            int corner = vertex_adjacency.corners[i];
+            int index_triangle = corner / 3;
+            int slot_corner = triangle_slot(index_triangle) * 3 + corner % 3;
+            normal += Point3<Accumulator>(t[index_triangle].n);
+            if (Estimators::has_angle_defect)
+                angle_defeact_sum += corner_angle[slot_corner];
+            if (Estimators::has_vertex_areas)
+                area_mixed += corner_area_mixed[slot_corner];
+
+            // mean curvature per vertex: sum of (cot alpha + cot beta) (x_k - x_j) over the edges of the vertex,
+            // the part of this triangle was computed with its geometry
+            if (Estimators::has_cotan_mean)
+                mc_vertex_sum += Point3<Accumulator>(corner_laplacian[slot_corner * 3], corner_laplacian[slot_corner * 3 + 1], corner_laplacian[slot_corner * 3 + 2]);
+        }
+        Point3<Accumulator> laplacian_sum = mc_vertex_sum;       // in the rescaled coords
+        mc_vertex_sum = mc_vertex_sum * (Accumulator)file_scale; // edge vectors in the coords of the file
 
-        out_normals.push_back(normals[t[k].v[2]].x());
-        out_normals.push_back(normals[t[k].v[2]].y());
-        out_normals.push_back(normals[t[k].v[2]].z());
+        // normals
+        // average of norms of adj triangle of a vertex (sum of triangle norms / number of triangles), normalized
+        int triangles_count = vertex_adjacency.get_triangles_count(k);
+        if (triangles_count != 0)
+        {
+            normal = normal / triangles_count;
+        }
+        normal.normalize();
+        vertex_normal[0] = normal.x();
+        vertex_normal[1] = normal.y();
+        vertex_normal[2] = normal.z();
+
+        // k_G = (2PI - sum_angle_defeact)/A_mixed
+        gc = 0;
+        if (Estimators::has_angle_defect)
+            gc = ((2 * M_PI) - angle_defeact_sum) / area_mixed;
+
+        mc = 0;
+        if (Estimators::has_cotan_mean)
+        {
+            mc = (((1.0f / (2 * area_mixed)) * mc_vertex_sum).norm()) / 2.0f;
 
-        // normals flat shading
-        out_normals_triangle.push_back(t[k].n.x());
-        out_normals_triangle.push_back(t[k].n.y());
-        out_normals_triangle.push_back(t[k].n.z());
+            if (mc_vertex_sum * normal < 0)
+                mc = (-1) * mc;
+        }
 
-        out_normals_triangle.push_back(t[k].n.x());
-        out_normals_triangle.push_back(t[k].n.y());
-        out_normals_triangle.push_back(t[k].n.z());
+        // principal curvatures: H and K in the rescaled coords, the shape operator fitted to the edges of the one-ring
+        if (Estimators::has_principal_curvatures && principal_curvatures)
+        {
+            Accumulator mean_curvature = laplacian_sum.norm() / (4 * area_mixed);
+            if (laplacian_sum * normal < 0)
+                mean_curvature = -mean_curvature;
+            ShapeOperatorFit<Accumulator> fit(normal, mean_curvature);
+            Point3<Accumulator> position(positions.get(k));
+            for (int i = vertex_adjacency.corners_begin[k]; i < vertex_adjacency.corners_begin[k + 1]; i++)
+            {
+                int corner = vertex_adjacency.corners[i];
+                const int *triangle = t[corner / 3].v;
+                int c = corner % 3;
+                Accumulator weight = fabs(corner_area_mixed[triangle_slot(corner / 3) * 3 + c]) / 2;
+                fit.add_edge(Point3<Accumulator>(positions.get(triangle[c == 2 ? 0 : c + 1])) - position, weight);
+                fit.add_edge(Point3<Accumulator>(positions.get(triangle[c == 0 ? 2 : c - 1])) - position, weight);
+            }
+            fit.solve((Accumulator)((2 * M_PI) - angle_defeact_sum) / area_mixed, principal_curvatures, principal_directions);
+        }
+    }
 
-        out_normals_triangle.push_back(t[k].n.x());
-        out_normals_triangle.push_back(t[k].n.y());
-        out_normals_triangle.push_back(t[k].n.z());
+    /**
+     * Function to write the principal curvatures and directions of a vertex into the outputs of corner j of triangle k.
+     */
+    void set_principal_corner(PrincipalCurvatureOutputs &principal, int k, int j, int index_vertex)
+    {
+        size_t corner = (size_t)k * 3 + j;
+        principal.curvatures[corner * 2 + 0] = principal.curvatures_vertex[(size_t)index_vertex * 2 + 0];
+        principal.curvatures[corner * 2 + 1] = principal.curvatures_vertex[(size_t)index_vertex * 2 + 1];
+        for (int i = 0; i < 3; i++)
+        {
+            principal.directions_1[corner * 3 + i] = principal.directions_vertex[(size_t)index_vertex * 6 + i];
+            principal.directions_2[corner * 3 + i] = principal.directions_vertex[(size_t)index_vertex * 6 + 3 + i];
+        }
+    }
 
-        // ------ insert mean value per edge into vector ---------
-        // edge 0 : v1v2
-        double value_mean_curvature_edge = get_mean_curvature_edge(t[k].v[1], t[k].v[2]);
+    /**
+     * Function to get mean curvature of the edge opposite to a corner (0, 1, 2) of a triangle (0 if Estimators has not the
+     * mean curvature per edge)
+     */
+    double get_mean_curvature_edge(int index_triangle, int corner)
+    {
+        if (!Estimators::has_dihedral_mean)
+            return 0;
+        return edge_mean_curvature[mesh_edges.corner_edges[index_triangle * 3 + corner]];
+    }
 
-        out_mc.push_back((value_mean_curvature_edge));
-        out_mc.push_back((value_mean_curvature_edge));
-        out_mc.push_back((value_mean_curvature_edge));
-        mc_triangle_size_edge.push_back((value_mean_curvature_edge));
+    /**
+     * Function to load the mesh, find Gaussian Curvature, Mean Curvature...etc.
+     * The loops over the triangles, the edges and the vertices run on threads threads (see ParallelFor.h):
+     * each one computes values per corner, per edge or per vertex, so the results are the same with any number of threads.
+     * Every estimator of Estimators is computed in the same loops, the values only used by the others are not computed.
+     *
+     * After the mesh is read, the curvatures take 4 streaming passes, as few as the data dependencies allow (a value per
+     * edge needs its 2 triangles, a value per vertex all the triangles around it, the outputs per triangle their 3 vertices):
+     * 1. triangles: normals, values per corner (angle, part of the area of the vertex, cotangent Laplacian: the cotangents
+     *    are used where the positions are already loaded, they are not stored) and per triangle (area);
+     * 2. edges: mean curvature per edge, from the normals and areas of its 2 triangles;
+     * 3. vertices: one gather over the corners of each vertex sums the normal, the angles, the area and the cotangent
+     *    Laplacian, and writes the final values per vertex as floats (Gaussian curvature, mean curvature, normal);
+     * 4. triangles: the outputs per corner are copies of the floats per vertex and of the mean curvature of the edges.
+     * If principal is not NULL, the gather of pass 3 also fits the shape operator of the vertex to the edges of its
+     * one-ring (PrincipalCurvatures.h) and pass 4 copies k1, k2 and their directions to the corners.
+     * Bytes of the arrays read and written per triangle with doubles (about V = T / 2 vertices and E = 3T / 2 edges,
+     * each value counted every time it is accessed, before the cache), with the previous 6 passes (the cotangent weights
+     * per edge and the sums per vertex were stored, the vertices read the positions of their neighbours, then 2 passes
+     * over the triangles and one over the vertices computed the same curvatures 3 times per vertex) and now:
+     *                       before   now
+     *    triangles             188   236
+     *    edges                 282   246
+     *    vertices              446   216
+     *    outputs               636   396
+     *    total                1552  1094
+     */
+    bool load(const char *path, vector<float> &out_vertices, vector<float> &out_normals, vector<float> &out_normals_triangle, vector<float> &out_gc, vector<float> &out_mc, vector<float> &out_mc_vertex, vector<float> &gc_vertex_size, vector<float> &mc_triangle_size_edge, vector<float> &mc_vertex_size_vertex,
+              PrincipalCurvatureOutputs *principal = NULL)
+    {
+        // --------------------- Read file -----------------------------
+        set_load_progress(0.0f);
+        if (!read_mesh(path))
+            return false;
+        set_load_progress(0.2f);
+
+        // edges of the mesh, values per corner and per triangle for the mean curvature per edge
+        if (!build_mesh_edges(t, num_vertices, mesh_edges))
+            return false;
+        build_vertex_adjacency(t, num_vertices, mesh_edges, vertex_adjacency);
+
+        set_max_min_mesh(); // find min value and max value of a mesh (in order to rescale values correctly)
+
+        // rescaled positions, once for the whole load: the vertices as read are not needed any more
+        build_vertex_positions(v, min_coord, max_coord, interval, positions, threads);
+        v.clear();
+        v.shrink_to_fit();
+
+        compute_curvatures(out_vertices, out_normals, out_normals_triangle, out_gc, out_mc, out_mc_vertex, gc_vertex_size, mc_triangle_size_edge, mc_vertex_size_vertex, principal);
+        cout << "Object loaded" << endl;
+        set_load_progress(0.95f); // the rest is for the percentiles (Object::set_file)
+
+        // ------- clear vectors (kept for update_vertices) -------
+        if (use_incremental_updates)
+        {
+            triangle_update_slot.assign(num_triangles, -1);
+            vertex_update_slot.assign(num_vertices, -1);
+            is_edge_in_update.assign(mesh_edges.edges_count(), 0);
+        }
+        else
+        {
+            mesh_edges.clear();
 
-        // edge 1 : v2v0
-        value_mean_curvature_edge = get_mean_curvature_edge(t[k].v[2], t[k].v[0]);
+            edge_mean_curvature.clear();
+            edge_mean_curvature.shrink_to_fit();
+        }
+        // ----------------------------
 
-        out_mc.push_back((value_mean_curvature_edge));
-        out_mc.push_back((value_mean_curvature_edge));
-        out_mc.push_back((value_mean_curvature_edge));
-        mc_triangle_size_edge.push_back((value_mean_curvature_edge));
+        return true;
+    }
 
-        // edge 2: v0v1
-        value_mean_curvature_edge = get_mean_curvature_edge(t[k].v[0], t[k].v[1]);
+    /**
+     * Function to compute every curvature from the positions with the 4 passes of load() (the outputs are replaced).
+     * The edges must be built: it is called by load(), or after it if use_incremental_updates is true (the edges are kept).
+     */
+    void compute_curvatures(vector<float> &out_vertices, vector<float> &out_normals, vector<float> &out_normals_triangle, vector<float> &out_gc, vector<float> &out_mc, vector<float> &out_mc_vertex, vector<float> &gc_vertex_size, vector<float> &mc_triangle_size_edge, vector<float> &mc_vertex_size_vertex,
+                            PrincipalCurvatureOutputs *principal = NULL)
+    {
+        // values per corner (3 * triangle + corner), gathered per vertex through vertex_adjacency
+        vector<Scalar> corner_angle(Estimators::has_corner_angles ? num_triangles * 3 : 0);     // angle of the triangle at the corner
+        vector<Scalar> corner_area_mixed(Estimators::has_vertex_areas ? num_triangles * 3 : 0); // part of the Area mixed of the vertex of the corner
+        vector<Scalar> corner_laplacian(Estimators::has_cotan_mean ? num_triangles * 9 : 0);    // cotangent Laplacian of the corner (x, y, z)
+        vector<Scalar> triangle_area(num_triangles);
+        double file_scale = get_file_scale();
+
+        // ------- 1. triangles: normals, angles (for the angle defect), Area mixed, cotangent Laplacian and areas -------
+        // (the cotangents are only used inside the triangle: not stored)
+        TriangleGeometry<Scalar> geometry = {corner_angle.data(), corner_area_mixed.data(), NULL, triangle_area.data(), Estimators::has_cotan_mean ? corner_laplacian.data() : NULL};
+        // ranges of groups of 4 triangles: the same triangles go through the AVX2 kernel (and its scalar tail) whatever
+        // the number of threads, as in load_streaming
+        const int block_size = 16384; // triangles between two updates of the progress
+        parallel_for((num_triangles + 3) / 4, threads, [&](int begin_group, int end_group) {
+            int begin = begin_group * 4, end = min(num_triangles, end_group * 4);
+            for (int block = begin; block < end; block += block_size)
+            {
+                if (begin == 0) // the first range reports the progress of all of them
+                    set_load_progress(block, end, 0.2f, 0.6f);
+                compute_triangle_geometry<AreaEstimator, Estimators>(t.data(), positions.x.data(), positions.y.data(), positions.z.data(), block, min(end, block + block_size), geometry, use_simd_kernel);
+            }
+        });
+
+        // ------- 2. edges: mean curvature per edge -------
+        if (Estimators::has_dihedral_mean)
+            compute_edge_mean_curvature(triangle_area);
+        triangle_area.clear();
+        triangle_area.shrink_to_fit();
+        set_load_progress(0.7f);
+
+        // ------- 3. vertices: values per vertex, gathered from the corners around each vertex (in triangle order) -------
+        // sized first (their previous values are replaced), so every triangle and every vertex writes its own values
+        vector<float> *triangle_outputs[] = {&out_vertices, &out_normals, &out_normals_triangle, &out_gc, &out_mc, &out_mc_vertex};
+        for (int i = 0; i < 6; i++)
+            triangle_outputs[i]->resize((size_t)num_triangles * 9);
+        mc_triangle_size_edge.resize((size_t)num_triangles * 3);
+        gc_vertex_size.resize(num_vertices);
+        mc_vertex_size_vertex.resize(num_vertices);
+        vector<float> vertex_normals((size_t)num_vertices * 3);
+        if (principal) // 0 if Estimators has not the principal curvatures
+        {
+            vector<float> *principal_outputs[] = {&principal->curvatures, &principal->directions_1, &principal->directions_2, &principal->curvatures_vertex, &principal->directions_vertex};
+            size_t sizes[] = {(size_t)num_triangles * 6, (size_t)num_triangles * 9, (size_t)num_triangles * 9, (size_t)num_vertices * 2, (size_t)num_vertices * 6};
+            for (int i = 0; i < 5; i++)
+                if (Estimators::has_principal_curvatures)
+                    principal_outputs[i]->resize(sizes[i]);
+                else
+                    principal_outputs[i]->assign(sizes[i], 0.0f);
+        }
 
-        out_mc.push_back((value_mean_curvature_edge));
-        out_mc.push_back((value_mean_curvature_edge));
-        out_mc.push_back((value_mean_curvature_edge));
-        mc_triangle_size_edge.push_back((value_mean_curvature_edge));
+        parallel_for(num_vertices, threads, [&](int begin, int end) {
+            for (int k = begin; k < end; k++)
+            {
+                if (begin == 0) // the first range reports the progress of all of them
+                    set_load_progress(k, end, 0.7f, 0.8f);
+                compute_vertex_values(k, corner_angle.data(), corner_area_mixed.data(), corner_laplacian.data(), [](int triangle) { return triangle; }, file_scale,
+                                      &vertex_normals[(size_t)k * 3], gc_vertex_size[k], mc_vertex_size_vertex[k],
+                                      principal ? &principal->curvatures_vertex[(size_t)k * 2] : NULL, principal ? &principal->directions_vertex[(size_t)k * 6] : NULL);
+            }
+        });
+        corner_angle.clear();
+        corner_angle.shrink_to_fit();
+        corner_laplacian.clear();
+        corner_laplacian.shrink_to_fit();
+        corner_area_mixed.clear();
+        corner_area_mixed.shrink_to_fit();
+
+        // ------- 4. output vectors: for each vertex of each triangle -------
+        parallel_for(num_triangles, threads, [&](int begin, int end) {
+            for (int k = begin; k < end; k++)
+            {
+                if (begin == 0) // the first range reports the progress of all of them
+                    set_load_progress(k, end, 0.8f, 0.95f);
+
+                size_t first = (size_t)k * 9;
+                for (int j = 0; j < 3; j++) // vertex 0, 1, 2
+                {
+                    int index_vertex = t[k].v[j];
+                    for (int i = 0; i < 3; i++)
+                    {
+                        out_gc[first + j * 3 + i] = gc_vertex_size[index_vertex];
+                        out_mc_vertex[first + j * 3 + i] = mc_vertex_size_vertex[index_vertex];
+
+                        // normals per vertex (smooth shading) and of the triangle (flat shading)
+                        out_normals[first + j * 3 + i] = vertex_normals[(size_t)index_vertex * 3 + i];
+                        out_normals_triangle[first + j * 3 + i] = t[k].n[i];
+                    }
+
+                    // insert vertices values in out_vertices
+                    out_vertices[first + j * 3 + 0] = positions.x[index_vertex];
+                    out_vertices[first + j * 3 + 1] = positions.y[index_vertex];
+                    out_vertices[first + j * 3 + 2] = positions.z[index_vertex];
+
+                    // ------ insert mean value per edge into vector ---------
+                    // edge 0 : v1v2, edge 1 : v2v0, edge 2: v0v1
+                    double value_mean_curvature_edge = get_mean_curvature_edge(k, j);
+
+                    out_mc[first + j * 3 + 0] = value_mean_curvature_edge;
+                    out_mc[first + j * 3 + 1] = value_mean_curvature_edge;
+                    out_mc[first + j * 3 + 2] = value_mean_curvature_edge;
+                    mc_triangle_size_edge[(size_t)k * 3 + j] = value_mean_curvature_edge;
+
+                    if (principal)
+                        set_principal_corner(*principal, k, j, index_vertex);
+                }
+            }
+        });
     }
 
-    // ofstream file_output;
-    // string path_name = path;
-    // file_output.open (path_name + ".txt");
-    for (int k = 0; k < num_vertices; k++)
+    /**
+     * Function to move vertices (new positions in the rescaled coords of the outputs, the rescaling is not changed) and
+     * update the outputs of load() in place, after a load with use_incremental_updates. Only the values that depend on
+     * the moved vertices are computed again, in time proportional to the size of the edit:
+     * - the geometry of the triangles around the moved vertices (normals, areas, values of the corners) changes;
+     * - so do the values of the vertices of these triangles (the one-ring of the moved vertices), gathered from all the
+     *   triangles around them (the geometry of those that did not move is computed again, it is not kept by load);
+     * - and the mean curvature of the edges of the moved triangles (both triangles of these edges are around the one-ring).
+     * update receives the triangles whose outputs changed (around the one-ring), the vertices and the edges. If they are
+     * more than 1 / INCREMENTAL_UPDATE_MAX_PART of the mesh everything is computed again by compute_curvatures.
+     * The values are the same as a load of the moved mesh with the same rescaling (up to the few ulps of the angles of the
+     * triangles computed by the AVX2 kernel in one case and not in the other, see use_simd_kernel).
+     * The vertices are indices in v and t, like the triangles of update (reordered with use_mesh_reordering: a vertex of
+     * the file is get_vertex_index(vertex)).
+     * A vertex given twice takes its last position. Return false if the edges were not kept or a vertex is invalid.
+     */
+    bool update_vertices(const vector<int> &vertices, const vector<Point3d> &new_positions, vector<float> &out_vertices, vector<float> &out_normals, vector<float> &out_normals_triangle, vector<float> &out_gc, vector<float> &out_mc, vector<float> &out_mc_vertex, vector<float> &gc_vertex_size, vector<float> &mc_triangle_size_edge, vector<float> &mc_vertex_size_vertex, CurvatureUpdate &update,
+                         PrincipalCurvatureOutputs *principal = NULL)
     {
-        // gc_vertex_size lenght = vertices
-        gc_vertex_size.push_back(((2 * M_PI) - value_angle_defeact_sum[k]) / area_mixed[k]);
-        float current_mean_curvature_value = (((1.0f / (2 * area_mixed[k])) * mean_curvature_vertex_sum[k]).norm()) / 2.0f;
+        update.triangles.clear();
+        update.vertices.clear();
+        update.edges.clear();
+        if (!use_incremental_updates || triangle_update_slot.size() != (size_t)num_triangles || out_vertices.size() != (size_t)num_triangles * 9)
+        {
+            cout << "The mesh was not loaded with use_incremental_updates, its curvatures cannot be updated." << endl;
+            return false;
+        }
+        if (principal && principal->curvatures_vertex.size() != (size_t)num_vertices * 2)
+        {
+            cout << "The principal curvatures were not computed by load." << endl;
+            return false;
+        }
+        if (vertices.size() != new_positions.size())
+        {
+            cout << "Not one position for each moved vertex." << endl;
+            return false;
+        }
+        for (size_t i = 0; i < vertices.size(); i++)
+            if (vertices[i] < 0 || vertices[i] >= num_vertices)
+            {
+                cout << "Invalid vertex index " << vertices[i] << "." << endl;
+                return false;
+            }
 
-        if (mean_curvature_vertex_sum[k] * normals[k] < 0)
-            current_mean_curvature_value = (-1) * current_mean_curvature_value;
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            positions.x[vertices[i]] = new_positions[i].x();
+            positions.y[vertices[i]] = new_positions[i].y();
+            positions.z[vertices[i]] = new_positions[i].z();
+        }
 
-        mc_vertex_size_vertex.push_back(current_mean_curvature_value);
-        // write in a file all values of Gaussian curvature
-        // file_output << ((2 * M_PI) - value_angle_defeact_sum[k]) / area_mixed[k] << "\n";
-    }
+        // ------- triangles around the moved vertices, their vertices, their edges and the triangles around the vertices -------
+        // found with the slots (-2: moved triangle, -3: triangle of the update), no search and no sort of duplicates
+        vector<int> moved_triangles;
+        for (size_t i = 0; i < vertices.size(); i++)
+            for (int c = vertex_adjacency.corners_begin[vertices[i]]; c < vertex_adjacency.corners_begin[vertices[i] + 1]; c++)
+            {
+                int k = vertex_adjacency.corners[c] / 3;
+                if (triangle_update_slot[k] == -1)
+                {
+                    triangle_update_slot[k] = -2;
+                    moved_triangles.push_back(k);
+                }
+            }
 
-    // file_output.close();
+        for (size_t i = 0; i < moved_triangles.size(); i++)
+            for (int j = 0; j < 3; j++)
+            {
+                int index_vertex = t[moved_triangles[i]].v[j];
+                if (vertex_update_slot[index_vertex] == -1)
+                {
+                    vertex_update_slot[index_vertex] = 0;
+                    update.vertices.push_back(index_vertex);
+                }
+                int e = mesh_edges.corner_edges[moved_triangles[i] * 3 + j];
+                if (Estimators::has_dihedral_mean && !is_edge_in_update[e])
+                {
+                    is_edge_in_update[e] = 1;
+                    update.edges.push_back(e);
+                }
+            }
 
-    // cout << path << " "<< number_obtuse_triangle << ", " << number_non_obtuse_triangle << endl;
-    cout << "Object loaded" << endl;
+        for (size_t i = 0; i < update.vertices.size(); i++)
+            for (int c = vertex_adjacency.corners_begin[update.vertices[i]]; c < vertex_adjacency.corners_begin[update.vertices[i] + 1]; c++)
+            {
+                int k = vertex_adjacency.corners[c] / 3;
+                if (triangle_update_slot[k] != -3)
+                {
+                    triangle_update_slot[k] = -3;
+                    update.triangles.push_back(k);
+                }
+            }
 
-    // ------- clear vectors -------
-    normals.clear();
-    normals.shrink_to_fit();
+        sort(update.triangles.begin(), update.triangles.end());
+        sort(update.vertices.begin(), update.vertices.end());
+        sort(update.edges.begin(), update.edges.end());
+        for (size_t i = 0; i < update.triangles.size(); i++)
+            triangle_update_slot[update.triangles[i]] = i;
+        for (size_t i = 0; i < update.vertices.size(); i++)
+            vertex_update_slot[update.vertices[i]] = i;
 
-    v_counter.clear();
-    v_counter.shrink_to_fit();
+        if (update.triangles.size() * INCREMENTAL_UPDATE_MAX_PART > (size_t)num_triangles) // big edit: the passes of load are faster
+        {
+            reset_update_slots(update);
+            compute_curvatures(out_vertices, out_normals, out_normals_triangle, out_gc, out_mc, out_mc_vertex, gc_vertex_size, mc_triangle_size_edge, mc_vertex_size_vertex, principal);
+            update.triangles.resize(num_triangles);
+            iota(update.triangles.begin(), update.triangles.end(), 0);
+            update.vertices.resize(num_vertices);
+            iota(update.vertices.begin(), update.vertices.end(), 0);
+            update.edges.resize(Estimators::has_dihedral_mean ? mesh_edges.edges_count() : 0);
+            iota(update.edges.begin(), update.edges.end(), 0);
+            return true;
+        }
 
-    value_angle_defeact_sum.clear();
-    value_angle_defeact_sum.shrink_to_fit();
+        // ------- geometry of the triangles around the one-ring: slot i is triangle update.triangles[i] -------
+        int triangles_count = update.triangles.size();
+        vector<Triangle> slot_triangles(triangles_count);
+        for (int i = 0; i < triangles_count; i++)
+            slot_triangles[i] = t[update.triangles[i]];
+        vector<Scalar> corner_angle(Estimators::has_corner_angles ? triangles_count * 3 : 0);
+        vector<Scalar> corner_area_mixed(Estimators::has_vertex_areas ? triangles_count * 3 : 0);
+        vector<Scalar> corner_laplacian(Estimators::has_cotan_mean ? triangles_count * 9 : 0);
+        vector<Scalar> triangle_area(triangles_count);
+        TriangleGeometry<Scalar> geometry = {corner_angle.data(), corner_area_mixed.data(), NULL, triangle_area.data(), Estimators::has_cotan_mean ? corner_laplacian.data() : NULL};
+        compute_triangle_geometry<AreaEstimator, Estimators>(slot_triangles.data(), positions.x.data(), positions.y.data(), positions.z.data(), 0, triangles_count, geometry, use_simd_kernel);
+
+        // only the normals of the moved triangles change (the others keep the values of load)
+        auto triangle_slot = [&](int k) { return triangle_update_slot[k]; };
+        for (size_t i = 0; i < moved_triangles.size(); i++)
+            t[moved_triangles[i]].n = slot_triangles[triangle_slot(moved_triangles[i])].n;
+
+        // ------- edges of the moved triangles -------
+        double file_scale = get_file_scale();
+        for (size_t i = 0; i < update.edges.size(); i++)
+            edge_mean_curvature[update.edges[i]] = get_edge_mean_curvature(update.edges[i], triangle_area.data(), triangle_slot, file_scale);
+
+        // ------- vertices of the moved triangles -------
+        vector<float> vertex_normals(update.vertices.size() * 3);
+        for (size_t i = 0; i < update.vertices.size(); i++)
+        {
+            int k = update.vertices[i];
+            compute_vertex_values(k, corner_angle.data(), corner_area_mixed.data(), corner_laplacian.data(), triangle_slot, file_scale, &vertex_normals[i * 3], gc_vertex_size[k], mc_vertex_size_vertex[k],
+                                  principal ? &principal->curvatures_vertex[(size_t)k * 2] : NULL, principal ? &principal->directions_vertex[(size_t)k * 6] : NULL);
+        }
 
-    map_edge.clear();
+        // ------- outputs of the triangles around the one-ring (the corners of the other vertices do not change) -------
+        for (int s = 0; s < triangles_count; s++)
+        {
+            int k = update.triangles[s];
+            size_t first = (size_t)k * 9;
+            for (int j = 0; j < 3; j++)
+            {
+                int index_vertex = t[k].v[j];
+                int vertex_slot = vertex_update_slot[index_vertex];
+                if (vertex_slot >= 0)
+                {
+                    for (int i = 0; i < 3; i++)
+                    {
+                        out_gc[first + j * 3 + i] = gc_vertex_size[index_vertex];
+                        out_mc_vertex[first + j * 3 + i] = mc_vertex_size_vertex[index_vertex];
+                        out_normals[first + j * 3 + i] = vertex_normals[vertex_slot * 3 + i];
+                    }
+                    if (principal)
+                        set_principal_corner(*principal, k, j, index_vertex);
+                }
+                for (int i = 0; i < 3; i++)
+                    out_normals_triangle[first + j * 3 + i] = t[k].n[i];
+                out_vertices[first + j * 3 + 0] = positions.x[index_vertex];
+                out_vertices[first + j * 3 + 1] = positions.y[index_vertex];
+                out_vertices[first + j * 3 + 2] = positions.z[index_vertex];
+
+                double value_mean_curvature_edge = get_mean_curvature_edge(k, j);
+                out_mc[first + j * 3 + 0] = value_mean_curvature_edge;
+                out_mc[first + j * 3 + 1] = value_mean_curvature_edge;
+                out_mc[first + j * 3 + 2] = value_mean_curvature_edge;
+                mc_triangle_size_edge[(size_t)k * 3 + j] = value_mean_curvature_edge;
+            }
+        }
+        reset_update_slots(update);
+        return true;
+    }
 
-    vector_mc_sum.clear();
-    vector_mc_sum.shrink_to_fit();
+    /**
+     * Function to reset the slots of the triangles, vertices and edges of an update (to -1 and false) for the next one.
+     */
+    void reset_update_slots(const CurvatureUpdate &update)
+    {
+        for (size_t i = 0; i < update.triangles.size(); i++)
+            triangle_update_slot[update.triangles[i]] = -1;
+        for (size_t i = 0; i < update.vertices.size(); i++)
+            vertex_update_slot[update.vertices[i]] = -1;
+        for (size_t i = 0; i < update.edges.size(); i++)
+            is_edge_in_update[update.edges[i]] = 0;
+    }
 
-    area_mixed.clear();
-    area_mixed.shrink_to_fit();
+    /**
+     * Number of triangles of the loaded mesh.
+     */
+    int get_number_triangles()
+    {
+        return num_triangles;
+    }
 
-    mean_curvature_vertex_sum.clear();
-    mean_curvature_vertex_sum.shrink_to_fit();
+  private:
+    void set_load_progress(float value)
+    {
+        if (progress)
+            *progress = value;
+    }
 
-    // ----------------------------
+    /**
+     * Update the progress during a loop: the loop goes from start to end of the whole load.
+     */
+    void set_load_progress(int k, int count, float start, float end)
+    {
+        if ((k & 16383) == 0)
+            set_load_progress(start + (end - start) * k / max(count, 1));
+    }
+};
 
-    return true;
+// engine of the default precisions: geometry and sums in double, positions stored in float
+typedef BasicMeshCurvature<double, double, MixedVoronoiArea, AllCurvatureEstimators, float> MeshCurvature;
+
+/**
+ * Call visitor(engine) with an engine BasicMeshCurvature<Scalar, Accumulator> whose positions are floats if
+ * use_float_positions is true, else Scalar.
+ */
+template <typename Scalar, typename Accumulator, typename Visitor>
+void visit_mesh_curvature_positions(atomic<float> *progress, Visitor &visitor)
+{
+    if (use_float_positions)
+    {
+        BasicMeshCurvature<Scalar, Accumulator, MixedVoronoiArea, AllCurvatureEstimators, float> mesh(progress);
+        visitor(mesh);
+    }
+    else
+    {
+        BasicMeshCurvature<Scalar, Accumulator> mesh(progress);
+        visitor(mesh);
+    }
+}
+
+/**
+ * Call visitor(engine) with an engine BasicMeshCurvature<Scalar, accumulation>.
+ */
+template <typename Scalar, typename Visitor>
+void visit_mesh_curvature(CurvaturePrecision accumulation, atomic<float> *progress, Visitor &visitor)
+{
+    switch (accumulation)
+    {
+    case PRECISION_FLOAT:
+        visit_mesh_curvature_positions<Scalar, float>(progress, visitor);
+        break;
+    case PRECISION_LONG_DOUBLE:
+        visit_mesh_curvature_positions<Scalar, long double>(progress, visitor);
+        break;
+    default:
+        visit_mesh_curvature_positions<Scalar, double>(progress, visitor);
+        break;
+    }
 }
 
-int get_number_triangles()
+/**
+ * Call visitor(engine) with an engine of the precisions chosen at run time (the visitor has a template operator(),
+ * one instantiation for each precision).
+ */
+template <typename Visitor>
+void visit_mesh_curvature(CurvaturePrecision precision, CurvaturePrecision accumulation, atomic<float> *progress, Visitor &visitor)
 {
-    return num_triangles;
+    switch (precision)
+    {
+    case PRECISION_FLOAT:
+        visit_mesh_curvature<float>(accumulation, progress, visitor);
+        break;
+    case PRECISION_LONG_DOUBLE:
+        visit_mesh_curvature<long double>(accumulation, progress, visitor);
+        break;
+    default:
+        visit_mesh_curvature<double>(accumulation, progress, visitor);
+        break;
+    }
 }
 
 #endif
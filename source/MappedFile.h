@@ -0,0 +1,159 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <functional>
+
+#if defined(_WIN32)
+#include <vector>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/***************************************************************************
+MappedFile.h
+Comment:  This file contains a read-only memory mapping of a whole file.
+***************************************************************************/
+
+/**
+ * Read-only view of the bytes of a file.
+ * On POSIX systems the file is mapped with mmap, so parsers can read the bytes directly
+ * without copying them into streams or strings. On other systems the file is read into a buffer.
+ */
+class MappedFile
+{
+  public:
+    MappedFile() : bytes(NULL), length(0)
+    {
+#if !defined(_WIN32)
+        descriptor = -1;
+#endif
+    }
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    /**
+     * Open and map the file at the given path. Return false if the file cannot be read.
+     */
+    bool open(const char *path)
+    {
+        close();
+#if defined(_WIN32)
+        FILE *file = fopen(path, "rb");
+        if (!file)
+            return false;
+        fseek(file, 0, SEEK_END);
+        long file_size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (file_size < 0)
+        {
+            fclose(file);
+            return false;
+        }
+        buffer.resize(file_size);
+        length = fread(buffer.data(), 1, file_size, file);
+        fclose(file);
+        bytes = buffer.data();
+        return length == (size_t)file_size;
+#else
+        descriptor = ::open(path, O_RDONLY);
+        if (descriptor < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(descriptor, &info) != 0)
+        {
+            close();
+            return false;
+        }
+
+        length = info.st_size;
+        if (length == 0) // mmap does not accept empty files
+            return true;
+
+        void *address = mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED)
+        {
+            close();
+            return false;
+        }
+        bytes = (const char *)address;
+        madvise(address, length, MADV_SEQUENTIAL); // files are parsed from the beginning to the end
+        return true;
+#endif
+    }
+
+    /**
+     * Unmap the file (it is called automatically by the destructor).
+     */
+    void close()
+    {
+#if defined(_WIN32)
+        buffer.clear();
+#else
+        if (bytes)
+            munmap((void *)bytes, length);
+        if (descriptor >= 0)
+            ::close(descriptor);
+        descriptor = -1;
+#endif
+        bytes = NULL;
+        length = 0;
+    }
+
+    const char *begin() const
+    {
+        return bytes;
+    }
+
+    const char *end() const
+    {
+        return bytes + length;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+  private:
+    // a mapping cannot be shared between two objects
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    const char *bytes;
+    size_t length;
+#if defined(_WIN32)
+    std::vector<char> buffer;
+#else
+    int descriptor;
+#endif
+};
+
+/**
+ * Name of a temporary file next to path, unique to the process and the thread that writes it: files written by
+ * several processes or engines at the same time (then renamed to path) do not overwrite each other.
+ */
+inline std::string get_temporary_path(const std::string &path)
+{
+#if defined(_WIN32)
+    unsigned long process = _getpid();
+#else
+    unsigned long process = getpid();
+#endif
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), ".%lu.%zx.tmp", process, std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return path + suffix;
+}
+
+#endif
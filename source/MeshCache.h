@@ -0,0 +1,142 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include "Point3.h"
+#include "MappedFile.h"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+/***************************************************************************
+MeshCache.h
+Comment:  This file contains a binary cache of the meshes read from text files.
+***************************************************************************/
+
+/**
+ * A mesh cache is a file written next to the mesh (path + ".meshcache") with:
+ * - MeshCacheHeader,
+ * - num_vertices * 3 doubles (x y z of each vertex),
+ * - num_triangles * 3 int32 (indices of each triangle).
+ * The header stores size and modification time of the mesh file: if the mesh changes the cache is ignored and rewritten.
+ */
+struct MeshCacheHeader
+{
+    char magic[8];         // "MESHBIN"
+    uint32_t version;      // MESH_CACHE_VERSION
+    uint32_t point_size;   // sizeof(Point3d), the cache is not portable between different layouts
+    uint64_t source_size;  // size of the mesh file
+    int64_t source_mtime;  // modification time of the mesh file
+    int32_t num_vertices;  // number of vertices
+    int32_t num_triangles; // number of triangles
+};
+
+const char MESH_CACHE_MAGIC[8] = "MESHBIN";
+const uint32_t MESH_CACHE_VERSION = 2; // increase it when the readers change
+
+/**
+ * Path of the cache of a mesh.
+ */
+inline std::string get_mesh_cache_path(const char *path)
+{
+    return std::string(path) + ".meshcache";
+}
+
+/**
+ * Get size and modification time of a file.
+ */
+inline bool get_file_key(const char *path, uint64_t &size, int64_t &mtime)
+{
+    struct stat info;
+    if (stat(path, &info) != 0)
+        return false;
+    size = info.st_size;
+    mtime = info.st_mtime;
+    return true;
+}
+
+/**
+ * Read the cache of the mesh at path (if it exists and it is up to date) into out_v and out_t.
+ * The cache is mapped in memory and copied with one memcpy for the vertices.
+ */
+template <typename TriangleType>
+bool read_mesh_cache(const char *path, std::vector<Point3d> &out_v, std::vector<TriangleType> &out_t)
+{
+    uint64_t source_size;
+    int64_t source_mtime;
+    if (!get_file_key(path, source_size, source_mtime))
+        return false;
+
+    MappedFile file;
+    if (!file.open(get_mesh_cache_path(path).c_str()) || file.size() < sizeof(MeshCacheHeader))
+        return false;
+
+    MeshCacheHeader header;
+    memcpy(&header, file.begin(), sizeof(header));
+    if (memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != MESH_CACHE_VERSION || header.point_size != sizeof(Point3d) ||
+        header.source_size != source_size || header.source_mtime != source_mtime || header.num_vertices < 0 || header.num_triangles < 0)
+        return false;
+
+    size_t vertices_bytes = (size_t)header.num_vertices * 3 * sizeof(double);
+    size_t triangles_bytes = (size_t)header.num_triangles * 3 * sizeof(int32_t);
+    if (file.size() != sizeof(header) + vertices_bytes + triangles_bytes)
+        return false;
+
+    const char *data = file.begin() + sizeof(header);
+    out_v.resize(header.num_vertices);
+    if (vertices_bytes > 0)
+        memcpy(&out_v[0], data, vertices_bytes); // Point3d is 3 contiguous doubles
+
+    const char *indices = data + vertices_bytes;
+    out_t.resize(header.num_triangles);
+    for (int i = 0; i < header.num_triangles; i++)
+        memcpy(out_t[i].v, indices + (size_t)i * 3 * sizeof(int32_t), 3 * sizeof(int32_t));
+
+    return true;
+}
+
+/**
+ * Write the cache of the mesh at path. The cache is written in a temporary file of this thread and renamed,
+ * so a reader never sees a partial cache.
+ */
+template <typename TriangleType>
+bool write_mesh_cache(const char *path, const std::vector<Point3d> &in_v, const std::vector<TriangleType> &in_t)
+{
+    MeshCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!get_file_key(path, header.source_size, header.source_mtime))
+        return false;
+    memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.point_size = sizeof(Point3d);
+    header.num_vertices = in_v.size();
+    header.num_triangles = in_t.size();
+
+    std::string cache_path = get_mesh_cache_path(path);
+    std::string temporary_path = get_temporary_path(cache_path);
+    FILE *file = fopen(temporary_path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    bool is_written = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (is_written && !in_v.empty())
+        is_written = fwrite(&in_v[0], sizeof(Point3d), in_v.size(), file) == in_v.size();
+
+    std::vector<int32_t> indices(in_t.size() * 3);
+    for (size_t i = 0; i < in_t.size(); i++)
+        memcpy(&indices[i * 3], in_t[i].v, 3 * sizeof(int32_t));
+    if (is_written && !indices.empty())
+        is_written = fwrite(&indices[0], sizeof(int32_t), indices.size(), file) == indices.size();
+
+    is_written = (fclose(file) == 0) && is_written;
+    if (!is_written || rename(temporary_path.c_str(), cache_path.c_str()) != 0)
+    {
+        remove(temporary_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef MESHEDGES_H
+#define MESHEDGES_H
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+/***************************************************************************
+MeshEdges.h
+Comment:  This file builds the edges of a triangle mesh and their incidences.
+***************************************************************************/
+
+/**
+ * Corners: corner c of triangle k is 3 * k + c, the edge opposite to it goes from v[(c + 1) % 3] to v[(c + 2) % 3]
+ * (corner 0 -> edge v1v2, corner 1 -> edge v2v0, corner 2 -> edge v0v1).
+ * The 3F corners are sorted by their edge (smaller index, bigger index) with two stable counting sorts
+ * (radix sort with radix V: first by the bigger index, then by the smaller one), so all the edges are found in one
+ * bulk step, numbered densely in the order of their keys, and the corners of an edge stay in triangle order.
+ */
+struct MeshEdges
+{
+    std::vector<int> edge_v1;            // smaller vertex of each edge
+    std::vector<int> edge_v2;            // bigger vertex of each edge
+    std::vector<int> sides_begin;        // corners opposite to edge e: sides[sides_begin[e]] ... sides[sides_begin[e + 1] - 1]
+    std::vector<int> sides;              // corners grouped by edge, in triangle order
+    std::vector<int> corner_edges;       // corner -> edge opposite to the corner
+    std::vector<int> vertex_edges_begin; // edges with edge_v1 == vertex: vertex_edges_begin[vertex] ... vertex_edges_begin[vertex + 1] - 1
+
+    int edges_count() const
+    {
+        return edge_v1.size();
+    }
+
+    /**
+     * Free the memory.
+     */
+    void clear()
+    {
+        std::vector<int>().swap(edge_v1);
+        std::vector<int>().swap(edge_v2);
+        std::vector<int>().swap(sides_begin);
+        std::vector<int>().swap(sides);
+        std::vector<int>().swap(corner_edges);
+        std::vector<int>().swap(vertex_edges_begin);
+    }
+};
+
+/**
+ * Smaller and bigger vertex of the edge opposite to a corner.
+ */
+template <typename TriangleType>
+inline void get_corner_edge(const std::vector<TriangleType> &triangles, int corner, int &index_v1, int &index_v2)
+{
+    const int *triangle = triangles[corner / 3].v;
+    int c = corner % 3;
+    index_v1 = triangle[c == 2 ? 0 : c + 1];
+    index_v2 = triangle[c == 0 ? 2 : c - 1];
+    if (index_v1 > index_v2)
+    {
+        int tmp = index_v1;
+        index_v1 = index_v2;
+        index_v2 = tmp;
+    }
+}
+
+/**
+ * Check that the vertex indices of the triangles are between 0 and vertices_count - 1 (everything indexed by vertex
+ * relies on it). Return false, with a message, at the first invalid index.
+ */
+template <typename TriangleType>
+bool check_triangle_indices(const std::vector<TriangleType> &triangles, int vertices_count)
+{
+    for (size_t k = 0; k < triangles.size(); k++)
+        for (int j = 0; j < 3; j++)
+            if (triangles[k].v[j] < 0 || triangles[k].v[j] >= vertices_count)
+            {
+                std::cout << "Invalid vertex index " << triangles[k].v[j] << " in triangle " << k << "." << std::endl;
+                return false;
+            }
+    return true;
+}
+
+/**
+ * Build the edges of the triangles (vertices_count vertices). Return false if a triangle has an invalid vertex index.
+ */
+template <typename TriangleType>
+bool build_mesh_edges(const std::vector<TriangleType> &triangles, int vertices_count, MeshEdges &edges)
+{
+    int corners_count = triangles.size() * 3;
+    if (!check_triangle_indices(triangles, vertices_count))
+        return false;
+
+    // ------- first counting sort: by bigger index -------
+    std::vector<int> begin(vertices_count + 1, 0);
+    int index_v1, index_v2;
+    for (int corner = 0; corner < corners_count; corner++)
+    {
+        get_corner_edge(triangles, corner, index_v1, index_v2);
+        begin[index_v2 + 1]++;
+    }
+    for (int i = 0; i < vertices_count; i++)
+        begin[i + 1] += begin[i];
+
+    std::vector<int> by_v2(corners_count);
+    for (int corner = 0; corner < corners_count; corner++)
+    {
+        get_corner_edge(triangles, corner, index_v1, index_v2);
+        by_v2[begin[index_v2]++] = corner;
+    }
+
+    // ------- second counting sort (stable): by smaller index -------
+    std::fill(begin.begin(), begin.end(), 0);
+    for (int corner = 0; corner < corners_count; corner++)
+    {
+        get_corner_edge(triangles, corner, index_v1, index_v2);
+        begin[index_v1 + 1]++;
+    }
+    for (int i = 0; i < vertices_count; i++)
+        begin[i + 1] += begin[i];
+
+    edges.sides.resize(corners_count);
+    for (int i = 0; i < corners_count; i++)
+    {
+        get_corner_edge(triangles, by_v2[i], index_v1, index_v2);
+        edges.sides[begin[index_v1]++] = by_v2[i];
+    }
+    by_v2.clear();
+    by_v2.shrink_to_fit();
+
+    // ------- dense edge ids: a new edge starts where the key changes -------
+    edges.edge_v1.clear();
+    edges.edge_v2.clear();
+    edges.sides_begin.clear();
+    edges.edge_v1.reserve(corners_count / 2 + 1);
+    edges.edge_v2.reserve(corners_count / 2 + 1);
+    edges.sides_begin.reserve(corners_count / 2 + 2);
+    edges.corner_edges.resize(corners_count);
+    edges.vertex_edges_begin.assign(vertices_count + 1, 0);
+    for (int i = 0; i < corners_count; i++)
+    {
+        get_corner_edge(triangles, edges.sides[i], index_v1, index_v2);
+        if (edges.edge_v1.empty() || index_v1 != edges.edge_v1.back() || index_v2 != edges.edge_v2.back())
+        {
+            edges.edge_v1.push_back(index_v1);
+            edges.edge_v2.push_back(index_v2);
+            edges.sides_begin.push_back(i);
+            edges.vertex_edges_begin[index_v1 + 1]++;
+        }
+        edges.corner_edges[edges.sides[i]] = edges.edge_v1.size() - 1;
+    }
+    edges.sides_begin.push_back(corners_count);
+    for (int i = 0; i < vertices_count; i++)
+        edges.vertex_edges_begin[i + 1] += edges.vertex_edges_begin[i];
+    return true;
+}
+
+/**
+ * Edge between two vertices (in any order), -1 if there is none. O(edges of the smaller vertex).
+ */
+inline int find_mesh_edge(const MeshEdges &edges, int index_v1, int index_v2)
+{
+    if (index_v1 > index_v2)
+    {
+        int tmp = index_v1;
+        index_v1 = index_v2;
+        index_v2 = tmp;
+    }
+    if (index_v1 < 0 || index_v1 + 1 >= (int)edges.vertex_edges_begin.size())
+        return -1;
+    for (int e = edges.vertex_edges_begin[index_v1]; e < edges.vertex_edges_begin[index_v1 + 1]; e++)
+        if (edges.edge_v2[e] == index_v2)
+            return e;
+    return -1;
+}
+
+#endif
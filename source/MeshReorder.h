@@ -0,0 +1,246 @@
+#ifndef MESHREORDER_H
+#define MESHREORDER_H
+
+#include "Point3.h"
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+/***************************************************************************
+MeshReorder.h
+Comment:  This file reorders the vertices and the triangles of a mesh for cache locality.
+***************************************************************************/
+
+/**
+ * Vertices are sorted along a Morton (Z-order) curve, so vertices close in space are close in memory.
+ * Triangles are then sorted with Tipsify (Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality
+ * and Reduced Overdraw", 2007): triangles are emitted in fans around a vertex, and the next fan vertex is one
+ * still in a simulated FIFO vertex cache of cache_size entries.
+ * The quality of a triangle order is measured as ACMR (average cache miss ratio: vertex cache misses per triangle,
+ * between 0.5 for a perfect order of a big mesh and 3).
+ */
+
+static const int reorder_cache_size = 16; // entries of the simulated FIFO vertex cache
+
+/**
+ * Results of reorder_mesh.
+ */
+struct ReorderStatistics
+{
+    long cache_misses_before;
+    long cache_misses_after;
+    double acmr_before;
+    double acmr_after;
+};
+
+/**
+ * Spread the 21 lowest bits of value to every third bit.
+ */
+inline uint64_t spread_morton_bits(uint64_t value)
+{
+    value &= 0x1FFFFF;
+    value = (value | value << 32) & 0x1F00000000FFFFULL;
+    value = (value | value << 16) & 0x1F0000FF0000FFULL;
+    value = (value | value << 8) & 0x100F00F00F00F00FULL;
+    value = (value | value << 4) & 0x10C30C30C30C30C3ULL;
+    value = (value | value << 2) & 0x1249249249249249ULL;
+    return value;
+}
+
+/**
+ * Vertex cache misses of the triangles drawn in order (FIFO cache of cache_size vertices).
+ */
+template <typename TriangleType>
+long get_vertex_cache_misses(const std::vector<TriangleType> &triangles, int vertices_count, int cache_size)
+{
+    std::vector<long> time_stamp(vertices_count, -1); // time when the vertex entered the cache
+    long misses = 0;
+    for (size_t k = 0; k < triangles.size(); k++)
+        for (int j = 0; j < 3; j++)
+        {
+            int vertex = triangles[k].v[j];
+            if (time_stamp[vertex] < 0 || misses - time_stamp[vertex] > cache_size)
+            {
+                time_stamp[vertex] = misses;
+                misses++;
+            }
+        }
+    return misses;
+}
+
+/**
+ * Sort the vertices along a Morton curve, triangles are remapped. vertex_index (if not NULL) receives the new index
+ * of each vertex.
+ */
+template <typename TriangleType>
+void reorder_vertices_morton(std::vector<Point3d> &vertices, std::vector<TriangleType> &triangles, std::vector<int> *vertex_index = NULL)
+{
+    if (vertices.empty())
+        return;
+
+    Point3d minimum = vertices[0], maximum = vertices[0];
+    for (size_t i = 1; i < vertices.size(); i++)
+        for (int j = 0; j < 3; j++)
+        {
+            minimum[j] = std::min(minimum[j], vertices[i][j]);
+            maximum[j] = std::max(maximum[j], vertices[i][j]);
+        }
+
+    std::vector<std::pair<uint64_t, int> > codes(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        uint64_t code = 0;
+        for (int j = 0; j < 3; j++)
+        {
+            double extent = maximum[j] - minimum[j];
+            uint64_t cell = extent > 0 ? (uint64_t)((vertices[i][j] - minimum[j]) / extent * 2097151.0) : 0;
+            code |= spread_morton_bits(cell) << j;
+        }
+        codes[i] = std::make_pair(code, (int)i);
+    }
+    std::sort(codes.begin(), codes.end());
+
+    std::vector<int> new_index(vertices.size());
+    std::vector<Point3d> sorted_vertices(vertices.size());
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+        new_index[codes[i].second] = i;
+        sorted_vertices[i] = vertices[codes[i].second];
+    }
+    vertices.swap(sorted_vertices);
+
+    for (size_t k = 0; k < triangles.size(); k++)
+        for (int j = 0; j < 3; j++)
+            triangles[k].v[j] = new_index[triangles[k].v[j]];
+    if (vertex_index)
+        vertex_index->swap(new_index);
+}
+
+/**
+ * Next fan vertex of Tipsify: a vertex of the last fans still in the cache with live triangles,
+ * else the last vertex seen with live triangles (dead_end stack), else the next vertex with live triangles.
+ */
+inline int get_tipsify_next_vertex(const std::vector<int> &candidates, const std::vector<int> &live_triangles, const std::vector<long> &cache_time, long time, int cache_size, std::vector<int> &dead_end, int &cursor)
+{
+    int best = -1;
+    long best_priority = -1;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        int vertex = candidates[i];
+        if (live_triangles[vertex] <= 0)
+            continue;
+        long priority = 0;
+        if (time - cache_time[vertex] + 2 * live_triangles[vertex] <= cache_size) // still in the cache after its fan
+            priority = time - cache_time[vertex];
+        if (priority > best_priority)
+        {
+            best = vertex;
+            best_priority = priority;
+        }
+    }
+    if (best >= 0)
+        return best;
+
+    while (!dead_end.empty())
+    {
+        int vertex = dead_end.back();
+        dead_end.pop_back();
+        if (live_triangles[vertex] > 0)
+            return vertex;
+    }
+    for (; cursor < (int)live_triangles.size(); cursor++)
+        if (live_triangles[cursor] > 0)
+            return cursor;
+    return -1;
+}
+
+/**
+ * Sort the triangles with Tipsify for a vertex cache of cache_size entries. triangle_index (if not NULL) receives the
+ * new index of each triangle.
+ */
+template <typename TriangleType>
+void reorder_triangles_tipsify(std::vector<TriangleType> &triangles, int vertices_count, int cache_size, std::vector<int> *triangle_index = NULL)
+{
+    // vertex -> triangles
+    int triangles_count = triangles.size();
+    std::vector<int> begin(vertices_count + 1, 0);
+    for (int k = 0; k < triangles_count; k++)
+        for (int j = 0; j < 3; j++)
+            begin[triangles[k].v[j] + 1]++;
+    for (int i = 0; i < vertices_count; i++)
+        begin[i + 1] += begin[i];
+    std::vector<int> vertex_triangles(triangles_count * 3);
+    std::vector<int> position(begin.begin(), begin.end() - 1);
+    for (int k = 0; k < triangles_count; k++)
+        for (int j = 0; j < 3; j++)
+            vertex_triangles[position[triangles[k].v[j]]++] = k;
+
+    std::vector<int> live_triangles(vertices_count);
+    for (int i = 0; i < vertices_count; i++)
+        live_triangles[i] = begin[i + 1] - begin[i];
+
+    std::vector<long> cache_time(vertices_count, 0);
+    std::vector<bool> is_emitted(triangles_count, false);
+    std::vector<int> dead_end, candidates, order;
+    order.reserve(triangles_count);
+    long time = cache_size + 1;
+    int cursor = 0;
+
+    int fan_vertex = get_tipsify_next_vertex(candidates, live_triangles, cache_time, time, cache_size, dead_end, cursor);
+    while (fan_vertex >= 0)
+    {
+        candidates.clear();
+        for (int i = begin[fan_vertex]; i < begin[fan_vertex + 1]; i++)
+        {
+            int k = vertex_triangles[i];
+            if (is_emitted[k])
+                continue;
+            is_emitted[k] = true;
+            order.push_back(k);
+            for (int j = 0; j < 3; j++)
+            {
+                int vertex = triangles[k].v[j];
+                dead_end.push_back(vertex);
+                candidates.push_back(vertex);
+                live_triangles[vertex]--;
+                if (time - cache_time[vertex] > cache_size) // not in the cache: loaded now
+                    cache_time[vertex] = time++;
+            }
+        }
+        fan_vertex = get_tipsify_next_vertex(candidates, live_triangles, cache_time, time, cache_size, dead_end, cursor);
+    }
+
+    std::vector<TriangleType> sorted_triangles(triangles_count);
+    for (int k = 0; k < triangles_count; k++)
+        sorted_triangles[k] = triangles[order[k]];
+    triangles.swap(sorted_triangles);
+    if (triangle_index)
+    {
+        triangle_index->resize(triangles_count);
+        for (int k = 0; k < triangles_count; k++)
+            (*triangle_index)[order[k]] = k;
+    }
+}
+
+/**
+ * Morton order of the vertices then Tipsify order of the triangles. Return the vertex cache misses before and after.
+ * vertex_index and triangle_index (if not NULL) receive the new index of each vertex and of each triangle, so that
+ * values indexed in the order of the input can be found in the reordered mesh.
+ */
+template <typename TriangleType>
+ReorderStatistics reorder_mesh(std::vector<Point3d> &vertices, std::vector<TriangleType> &triangles, std::vector<int> *vertex_index = NULL, std::vector<int> *triangle_index = NULL)
+{
+    ReorderStatistics statistics;
+    double triangles_count = triangles.empty() ? 1 : triangles.size();
+    statistics.cache_misses_before = get_vertex_cache_misses(triangles, vertices.size(), reorder_cache_size);
+    statistics.acmr_before = statistics.cache_misses_before / triangles_count;
+
+    reorder_vertices_morton(vertices, triangles, vertex_index);
+    reorder_triangles_tipsify(triangles, vertices.size(), reorder_cache_size, triangle_index);
+
+    statistics.cache_misses_after = get_vertex_cache_misses(triangles, vertices.size(), reorder_cache_size);
+    statistics.acmr_after = statistics.cache_misses_after / triangles_count;
+    return statistics;
+}
+
+#endif
@@ -0,0 +1,320 @@
+#ifndef MESHTOKENIZER_H
+#define MESHTOKENIZER_H
+
+#include <stdint.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/***************************************************************************
+MeshTokenizer.h
+Comment:  This file contains a tokenizer for the numbers of text mesh formats (OFF, PLY, OBJ).
+***************************************************************************/
+
+/**
+ * Tokenizer that reads integers and floating point numbers from a range of bytes (for example a mapped file).
+ * Spaces, tabs, new lines and comments (from # to the end of the line) separate the tokens.
+ * - whitespace is skipped 16 bytes at a time with SSE2 (scalar code on other CPUs),
+ * - digits are converted 8 at a time with SWAR (one 64-bit word),
+ * - decimals with at most 19 significant digits whose value and power of ten are exact doubles
+ *   are converted with one multiplication/division (Clinger's fast path, correctly rounded like strtod),
+ *   the other numbers are converted by strtod.
+ */
+class MeshTokenizer
+{
+  public:
+    MeshTokenizer(const char *begin, const char *end) : p(begin), end(end) {}
+
+    /**
+     * Current position of the tokenizer.
+     */
+    const char *position() const
+    {
+        return p;
+    }
+
+    /**
+     * Return true if there are no more tokens.
+     */
+    bool at_end()
+    {
+        p = skip_whitespace(p, end);
+        return p == end;
+    }
+
+    /**
+     * Move the tokenizer at the end of the current line (before the \n).
+     */
+    void skip_line()
+    {
+        while (p < end && *p != '\n') // the rest of a line is usually short: no memchr call
+            p++;
+    }
+
+    /**
+     * Read the next token as a string (without copying it): it is between token_begin and token_end.
+     */
+    bool next_token(const char *&token_begin, const char *&token_end)
+    {
+        p = skip_whitespace(p, end);
+        token_begin = p;
+        while (p < end && !is_separator(*p))
+            p++;
+        token_end = p;
+        return token_begin != token_end;
+    }
+
+    /**
+     * Read the next token as an integer (at most 18 digits).
+     */
+    bool next_int(int64_t &value)
+    {
+        p = skip_whitespace(p, end);
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negative = (*p++ == '-');
+
+        const char *digits_begin = p;
+        int64_t result = 0;
+        while (p < end && is_digit(*p) && p - digits_begin < 18)
+            result = result * 10 + (*p++ - '0');
+
+        if (p == digits_begin || (p < end && !is_separator(*p)))
+            return false;
+
+        value = negative ? -result : result;
+        return true;
+    }
+
+    /**
+     * Read the next token as an integer, return false if it is out of the range of int.
+     */
+    bool next_int(int &value)
+    {
+        int64_t result;
+        if (!next_int(result) || result < INT_MIN || result > INT_MAX)
+            return false;
+        value = (int)result;
+        return true;
+    }
+
+    /**
+     * Read the next token as a double.
+     */
+    bool next_double(double &value)
+    {
+        p = skip_whitespace(p, end);
+        const char *start = p;
+
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negative = (*p++ == '-');
+
+        uint64_t mantissa = 0;
+        int digits = 0;   // significant digits in mantissa
+        int exponent = 0; // decimal exponent of mantissa
+        bool any_digit = false;
+
+        // integer part (leading zeros are not significant)
+        while (p < end && *p == '0')
+        {
+            p++;
+            any_digit = true;
+        }
+        const char *integer_begin = p;
+        p = read_digits(p, end, mantissa);
+        digits += p - integer_begin;
+        any_digit = any_digit || digits > 0;
+
+        // fractional part
+        if (p < end && *p == '.')
+        {
+            p++;
+            if (mantissa == 0)
+            {
+                while (p < end && *p == '0')
+                {
+                    p++;
+                    exponent--;
+                    any_digit = true;
+                }
+            }
+            const char *fraction_begin = p;
+            p = read_digits(p, end, mantissa);
+            digits += p - fraction_begin;
+            exponent -= p - fraction_begin;
+            any_digit = any_digit || p != fraction_begin;
+        }
+
+        // exponent
+        if (any_digit && p < end && (*p == 'e' || *p == 'E'))
+        {
+            const char *q = p + 1;
+            bool negative_exponent = false;
+            if (q < end && (*q == '-' || *q == '+'))
+                negative_exponent = (*q++ == '-');
+            if (q < end && is_digit(*q))
+            {
+                int e = 0;
+                while (q < end && is_digit(*q))
+                {
+                    if (e < 100000)
+                        e = e * 10 + (*q - '0');
+                    q++;
+                }
+                exponent += negative_exponent ? -e : e;
+                p = q;
+            }
+        }
+
+        bool is_terminated = (p == end || is_separator(*p));
+        if (any_digit && is_terminated && digits <= 19 && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+        {
+            static const double powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            double result = (double)mantissa;
+            if (exponent < 0)
+                result /= powers_of_ten[-exponent];
+            else
+                result *= powers_of_ten[exponent];
+            value = negative ? -result : result;
+            return true;
+        }
+
+        // slow path: long mantissa, big exponent, inf/nan
+        char token[64];
+        size_t length = 0;
+        p = start;
+        while (p < end && length < sizeof(token) - 1 && !is_separator(*p))
+            token[length++] = *p++;
+        token[length] = '\0';
+
+        char *token_end;
+        value = strtod(token, &token_end);
+        return length > 0 && token_end == token + length && (p == end || is_separator(*p));
+    }
+
+    /**
+     * Read the next token as a float (parsed as a double and rounded once).
+     */
+    bool next_float(float &value)
+    {
+        double result;
+        if (!next_double(result))
+            return false;
+        value = (float)result;
+        return true;
+    }
+
+    static bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool is_space(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static bool is_separator(char c)
+    {
+        return is_space(c) || c == '#';
+    }
+
+    /**
+     * Skip spaces, tabs, new lines and comments.
+     */
+    static const char *skip_whitespace(const char *p, const char *end)
+    {
+        while (p < end)
+        {
+            if (!is_space(*p))
+            {
+                if (*p != '#')
+                    return p;
+                const char *line_end = (const char *)memchr(p, '\n', end - p);
+                p = line_end ? line_end : end;
+                continue;
+            }
+            p++;
+#if defined(__SSE2__)
+            // long runs of spaces (indentation, empty lines): 16 bytes at a time
+            while (end - p >= 16 && is_space(*p))
+            {
+                __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+                __m128i spaces = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+                                              _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))));
+                unsigned int not_spaces = ~_mm_movemask_epi8(spaces) & 0xFFFF;
+                if (not_spaces != 0)
+                {
+                    p += __builtin_ctz(not_spaces);
+                    break;
+                }
+                p += 16;
+            }
+#endif
+            while (p < end && is_space(*p))
+                p++;
+        }
+        return p;
+    }
+
+  private:
+    /**
+     * Append the digits starting at p to mantissa (at most 19 digits are accumulated, the others are skipped
+     * but counted by the caller, so the slow path is used). Return the position after the digits.
+     */
+    static const char *read_digits(const char *p, const char *end, uint64_t &mantissa)
+    {
+        const char *begin = p;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        while (end - p >= 8 && p - begin <= 11)
+        {
+            uint64_t chunk;
+            memcpy(&chunk, p, 8);
+            if (!is_eight_digits(chunk))
+                break;
+            mantissa = mantissa * 100000000 + parse_eight_digits(chunk);
+            p += 8;
+        }
+#endif
+        while (p < end && is_digit(*p))
+        {
+            if (p - begin < 19)
+                mantissa = mantissa * 10 + (*p - '0');
+            p++;
+        }
+        return p;
+    }
+
+    /**
+     * Return true if the 8 bytes of chunk are all digits.
+     */
+    static bool is_eight_digits(uint64_t chunk)
+    {
+        return !(((chunk + 0x4646464646464646ULL) | (chunk - 0x3030303030303030ULL)) & 0x8080808080808080ULL);
+    }
+
+    /**
+     * Convert 8 digits stored in a little endian word.
+     */
+    static uint32_t parse_eight_digits(uint64_t chunk)
+    {
+        const uint64_t mask = 0x000000FF000000FFULL;
+        const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+        const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+        chunk -= 0x3030303030303030ULL;
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+        return (uint32_t)chunk;
+    }
+
+    const char *p;
+    const char *end;
+};
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef MULTISCALECURVATURE_H
+#define MULTISCALECURVATURE_H
+
+#include "VertexAdjacency.h"
+#include "VertexPositions.h"
+#include "ParallelFor.h"
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <cmath>
+
+/***************************************************************************
+MultiScaleCurvature.h
+Comment:  This file contains the curvatures per vertex averaged over neighbourhoods of increasing size (k-rings or balls).
+***************************************************************************/
+
+/**
+ * The curvatures of load() come from the one-ring of each vertex and are noisy on scanned meshes. At scale s the value
+ * of a vertex is the average of the values of the vertices of its neighbourhood, weighted by their barycentric areas
+ * (a third of the area of the triangles around them). It is a smoothing of the values of load(), not the angle defect
+ * of the region over its area: load() divides by the Area mixed, the weights are not the areas of those values.
+ * The values that are not finite (vertices without area, degenerate triangles) are left out of the averages.
+ * The neighbourhoods of the biggest scale are found once (bounded breadth-first search over VertexAdjacency) with the
+ * scale of each vertex in them (its ring, or its distance to the center), sorted by scale: the neighbourhood of every
+ * smaller scale is a prefix of it, so changing the scale does not walk the mesh again, and one pass over the
+ * neighbourhood of a vertex gives its values at all the scales.
+ * - k-ring: the vertices at most s edges away (scale 0 is the vertex alone, the values of load());
+ * - radius: the vertices at a distance of at most s from the center (rescaled coords) reached through vertices
+ *   that are too (the search does not jump between close sheets of the surface).
+ */
+
+enum NeighbourhoodType
+{
+    NEIGHBOURHOOD_K_RING,
+    NEIGHBOURHOOD_RADIUS
+};
+
+const char *neighbourhood_names[] = {"k-ring", "radius"};
+
+// ----- DEFAULT SETTINGS OF THE MULTI-SCALE MODE (read by Object::set_file) -----
+// if true Object::set_file finds the neighbourhoods of the vertices, see Object::set_curvature_scale
+bool use_multiscale_curvature = false;
+NeighbourhoodType multiscale_neighbourhood = NEIGHBOURHOOD_K_RING;
+int multiscale_max_rings = 4;        // biggest scale of the k-rings
+double multiscale_max_radius = 0.05; // biggest scale of the balls, in the rescaled coords (the mesh is between -1 and 1)
+// -------------------------
+
+/**
+ * Biggest scale of the neighbourhoods of multiscale_neighbourhood.
+ */
+inline double get_multiscale_max_scale()
+{
+    return multiscale_neighbourhood == NEIGHBOURHOOD_K_RING ? multiscale_max_rings : multiscale_max_radius;
+}
+
+// vertices whose neighbourhoods are found by a task of build_vertex_neighbourhoods
+const int NEIGHBOURHOOD_BLOCK_SIZE = 2048;
+
+/**
+ * Neighbourhoods of the vertices for the scales up to max_scale, in compressed sparse row form as VertexAdjacency:
+ * the vertices around vertex i are vertices[begin[i]] ... vertices[begin[i + 1] - 1], the vertex itself first, with
+ * increasing scales[].
+ */
+struct VertexNeighbourhoods
+{
+    NeighbourhoodType type;
+    double max_scale;
+    std::vector<int> begin;        // vertices + 1
+    std::vector<int> vertices;     // neighbourhood of each vertex
+    std::vector<float> scales;     // smallest scale of each vertex of a neighbourhood (ring or distance)
+    std::vector<float> areas;      // area of each vertex of the mesh, weight of its values
+
+    int vertices_count() const
+    {
+        return begin.empty() ? 0 : (int)begin.size() - 1;
+    }
+
+    /**
+     * Number of vertices in the neighbourhood of vertex at scale.
+     */
+    int get_size(int vertex, double scale) const
+    {
+        return std::upper_bound(scales.begin() + begin[vertex], scales.begin() + begin[vertex + 1], scale) - (scales.begin() + begin[vertex]);
+    }
+
+    /**
+     * Free the memory.
+     */
+    void clear()
+    {
+        std::vector<int>().swap(begin);
+        std::vector<int>().swap(vertices);
+        std::vector<float>().swap(scales);
+        std::vector<float>().swap(areas);
+    }
+};
+
+/**
+ * Area of each vertex: a third of the area of the triangles around it, gathered over its corners.
+ */
+template <typename TriangleType, typename Scalar>
+void compute_barycentric_vertex_areas(const std::vector<TriangleType> &triangles, const VertexPositions<Scalar> &positions, const VertexAdjacency &adjacency, std::vector<float> &areas, int threads_count)
+{
+    int triangles_count = triangles.size();
+    std::vector<double> triangle_area(triangles_count);
+    parallel_for(triangles_count, threads_count, [&](int begin, int end) {
+        for (int k = begin; k < end; k++)
+        {
+            Point3d p0(positions.get(triangles[k].v[0])), p1(positions.get(triangles[k].v[1])), p2(positions.get(triangles[k].v[2]));
+            triangle_area[k] = ((p1 - p0) ^ (p2 - p0)).norm() / 2;
+        }
+    });
+
+    int vertices_count = adjacency.corners_begin.size() - 1;
+    areas.resize(vertices_count);
+    parallel_for(vertices_count, threads_count, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            double area = 0;
+            for (int c = adjacency.corners_begin[i]; c < adjacency.corners_begin[i + 1]; c++)
+                area += triangle_area[adjacency.corners[c] / 3];
+            areas[i] = area / 3;
+        }
+    });
+}
+
+/**
+ * Find the neighbourhoods of the vertices up to max_scale (rings, or radius in the coords of positions) and the areas
+ * of the vertices. Blocks of NEIGHBOURHOOD_BLOCK_SIZE vertices are searched by threads_count threads, each one with
+ * its own marks, then copied one after the other, so the result does not depend on the number of threads.
+ */
+template <typename TriangleType, typename Scalar>
+void build_vertex_neighbourhoods(const std::vector<TriangleType> &triangles, const VertexPositions<Scalar> &positions, const VertexAdjacency &adjacency,
+                                 NeighbourhoodType type, double max_scale, VertexNeighbourhoods &neighbourhoods, int threads_count)
+{
+    int vertices_count = adjacency.corners_begin.size() - 1;
+    neighbourhoods.type = type;
+    neighbourhoods.max_scale = max_scale;
+    compute_barycentric_vertex_areas(triangles, positions, adjacency, neighbourhoods.areas, threads_count);
+
+    int blocks_count = (vertices_count + NEIGHBOURHOOD_BLOCK_SIZE - 1) / NEIGHBOURHOOD_BLOCK_SIZE;
+    std::vector<std::vector<int> > block_vertices(blocks_count);
+    std::vector<std::vector<float> > block_scales(blocks_count);
+    neighbourhoods.begin.assign(vertices_count + 1, 0);
+
+    // one range of blocks per thread (min_items 1): the blocks are much bigger than the cost of a thread
+    auto search_blocks = [&](int first_block, int last_block) {
+        std::vector<int> mark(vertices_count, -1); // center of the last search that reached each vertex
+        std::vector<std::pair<float, int> > found;
+        for (int b = first_block; b < last_block; b++)
+        {
+            std::vector<int> &out_vertices = block_vertices[b];
+            std::vector<float> &out_scales = block_scales[b];
+            for (int center = b * NEIGHBOURHOOD_BLOCK_SIZE; center < std::min(vertices_count, (b + 1) * NEIGHBOURHOOD_BLOCK_SIZE); center++)
+            {
+                // breadth-first search from the center: found[] is the queue, ordered by ring
+                double center_x = positions.x[center], center_y = positions.y[center], center_z = positions.z[center];
+                found.assign(1, std::make_pair(0.0f, center));
+                mark[center] = center;
+                for (size_t i = 0; i < found.size(); i++)
+                {
+                    int vertex = found[i].second;
+                    int ring = type == NEIGHBOURHOOD_K_RING ? (int)found[i].first : 0;
+                    if (type == NEIGHBOURHOOD_K_RING && ring + 1 > max_scale)
+                        break; // the rest of the queue is in the last ring
+                    for (int n = adjacency.neighbours_begin[vertex]; n < adjacency.neighbours_begin[vertex + 1]; n++)
+                    {
+                        int neighbour = adjacency.neighbours[n];
+                        if (mark[neighbour] == center)
+                            continue;
+                        mark[neighbour] = center; // also the vertices out of the ball: their distance is computed once
+                        if (type == NEIGHBOURHOOD_K_RING)
+                            found.push_back(std::make_pair((float)(ring + 1), neighbour));
+                        else
+                        {
+                            double dx = positions.x[neighbour] - center_x, dy = positions.y[neighbour] - center_y, dz = positions.z[neighbour] - center_z;
+                            double squared_distance = dx * dx + dy * dy + dz * dz;
+                            if (squared_distance <= max_scale * max_scale)
+                                found.push_back(std::make_pair((float)sqrt(squared_distance), neighbour));
+                        }
+                    }
+                }
+                if (type == NEIGHBOURHOOD_RADIUS)
+                    std::sort(found.begin() + 1, found.end()); // by distance, then by index
+
+                neighbourhoods.begin[center + 1] = found.size();
+                for (size_t i = 0; i < found.size(); i++)
+                {
+                    out_scales.push_back(found[i].first);
+                    out_vertices.push_back(found[i].second);
+                }
+            }
+        }
+    };
+    parallel_for(blocks_count, threads_count, search_blocks, 1);
+
+    for (int i = 0; i < vertices_count; i++)
+        neighbourhoods.begin[i + 1] += neighbourhoods.begin[i];
+    neighbourhoods.vertices.resize(neighbourhoods.begin[vertices_count]);
+    neighbourhoods.scales.resize(neighbourhoods.begin[vertices_count]);
+    auto copy_blocks = [&](int first_block, int last_block) {
+        for (int b = first_block; b < last_block; b++)
+        {
+            int offset = neighbourhoods.begin[b * NEIGHBOURHOOD_BLOCK_SIZE];
+            std::copy(block_vertices[b].begin(), block_vertices[b].end(), neighbourhoods.vertices.begin() + offset);
+            std::copy(block_scales[b].begin(), block_scales[b].end(), neighbourhoods.scales.begin() + offset);
+            std::vector<int>().swap(block_vertices[b]);
+            std::vector<float>().swap(block_scales[b]);
+        }
+    };
+    parallel_for(blocks_count, threads_count, copy_blocks, 1);
+}
+
+/**
+ * Average the values per vertex of each of values_count arrays over the neighbourhoods of each scale of scales
+ * (increasing, at most max_scale): outputs[s * values_count + i][vertex] is the value of array i at scales[s].
+ * One pass over the neighbourhood of each vertex gives all the scales. The values that are not finite are skipped
+ * (each array has its own sum of areas); a vertex alone, or without finite values of area > 0 around it, keeps its value.
+ * Return false if the scales are not valid.
+ */
+inline bool evaluate_multiscale_curvature(const VertexNeighbourhoods &neighbourhoods, const std::vector<float> *values[], int values_count, const std::vector<double> &scales,
+                                          std::vector<std::vector<float> > &outputs, int threads_count)
+{
+    for (size_t s = 0; s < scales.size(); s++)
+        if (scales[s] < 0 || scales[s] > neighbourhoods.max_scale || (s > 0 && scales[s] < scales[s - 1]))
+        {
+            std::cout << "The scales must be increasing, between 0 and " << neighbourhoods.max_scale << "." << std::endl;
+            return false;
+        }
+
+    int vertices_count = neighbourhoods.vertices_count();
+    outputs.resize(scales.size() * values_count);
+    for (size_t i = 0; i < outputs.size(); i++)
+        outputs[i].resize(vertices_count);
+
+    parallel_for(vertices_count, threads_count, [&](int begin, int end) {
+        std::vector<double> sums(values_count), areas(values_count);
+        for (int vertex = begin; vertex < end; vertex++)
+        {
+            std::fill(sums.begin(), sums.end(), 0.0);
+            std::fill(areas.begin(), areas.end(), 0.0);
+            int first = neighbourhoods.begin[vertex], last = neighbourhoods.begin[vertex + 1];
+            int j = first;
+            for (size_t s = 0; s < scales.size(); s++)
+            {
+                for (; j < last && neighbourhoods.scales[j] <= scales[s]; j++)
+                {
+                    int neighbour = neighbourhoods.vertices[j];
+                    double weight = neighbourhoods.areas[neighbour];
+                    for (int i = 0; i < values_count; i++)
+                    {
+                        float value = (*values[i])[neighbour];
+                        if (std::isfinite(value))
+                        {
+                            areas[i] += weight;
+                            sums[i] += weight * value;
+                        }
+                    }
+                }
+                for (int i = 0; i < values_count; i++)
+                    outputs[s * values_count + i][vertex] = j - first <= 1 || areas[i] <= 0 ? (*values[i])[vertex] : sums[i] / areas[i];
+            }
+        }
+    });
+    return true;
+}
+
+#endif
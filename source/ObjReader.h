@@ -0,0 +1,96 @@
+#ifndef OBJREADER_H
+#define OBJREADER_H
+
+#include "Point3.h"
+#include "MeshTokenizer.h"
+#include <vector>
+#include <iostream>
+#include <string.h>
+
+/***************************************************************************
+ObjReader.h
+Comment:  This file contains a reader of Wavefront OBJ files.
+***************************************************************************/
+
+/**
+ * Only "v x y z" and "f" lines are read, every other line (normals, texture coordinates, groups, materials) is skipped.
+ * Face vertices can be "i", "i/t", "i//n" or "i/t/n", negative indices are relative to the last vertex.
+ * Polygons are triangulated as a fan around their first vertex, the triangles of a face are consecutive in out_t.
+ */
+
+/**
+ * Convert the vertex of a face token ("i", "i/t", "i//n", "i/t/n") in a 0-based index.
+ */
+inline bool parse_obj_index(const char *begin, const char *end, int vertices_count, int &index)
+{
+    const char *slash = (const char *)memchr(begin, '/', end - begin);
+    MeshTokenizer tokenizer(begin, slash ? slash : end);
+    int value;
+    if (!tokenizer.next_int(value) || value == 0 || !tokenizer.at_end())
+        return false;
+    index = value > 0 ? value - 1 : vertices_count + value;
+    return true;
+}
+
+/**
+ * Parse the bytes of an OBJ file and fill out_v and out_t.
+ */
+template <typename TriangleType>
+bool parse_obj_buffer(const char *begin, const char *end, std::vector<Point3d> &out_v, std::vector<TriangleType> &out_t)
+{
+    out_v.clear();
+    out_t.clear();
+
+    int line_number = 0;
+    const char *p = begin;
+    while (p < end)
+    {
+        const char *line_end = (const char *)memchr(p, '\n', end - p);
+        if (!line_end)
+            line_end = end;
+        line_number++;
+
+        MeshTokenizer tokenizer(p, line_end);
+        const char *token_begin, *token_end;
+        if (tokenizer.next_token(token_begin, token_end) && token_end - token_begin == 1)
+        {
+            if (*token_begin == 'v')
+            {
+                double x, y, z;
+                if (!tokenizer.next_double(x) || !tokenizer.next_double(y) || !tokenizer.next_double(z))
+                {
+                    std::cout << "Invalid vertex at line " << line_number << " of OBJ file." << std::endl;
+                    return false;
+                }
+                out_v.push_back(Point3d(x, y, z));
+            }
+            else if (*token_begin == 'f')
+            {
+                TriangleType triangle;
+                for (int k = 0; k < 3; k++)
+                {
+                    if (!tokenizer.next_token(token_begin, token_end) || !parse_obj_index(token_begin, token_end, out_v.size(), triangle.v[k]))
+                    {
+                        std::cout << "Invalid face at line " << line_number << " of OBJ file." << std::endl;
+                        return false;
+                    }
+                }
+                out_t.push_back(triangle);
+                while (tokenizer.next_token(token_begin, token_end)) // polygon: [v0, v2, v3], [v0, v3, v4] ...
+                {
+                    triangle.v[1] = triangle.v[2];
+                    if (!parse_obj_index(token_begin, token_end, out_v.size(), triangle.v[2]))
+                    {
+                        std::cout << "Invalid face at line " << line_number << " of OBJ file." << std::endl;
+                        return false;
+                    }
+                    out_t.push_back(triangle);
+                }
+            }
+        }
+        p = line_end + 1;
+    }
+    return true;
+}
+
+#endif
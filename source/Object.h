@@ -6,6 +6,9 @@
 #include <math.h>
 #include "LoaderObject.h"
 #include "kPercentileHelper.h"
+#include "CurvatureCache.h"
+#include "MultiScaleCurvature.h"
+#include <memory>
 
 using namespace std;
 
@@ -13,6 +16,37 @@ using namespace std;
 Object.h
 Comment:  This file contains all Object definitions to construct and draw an object.
 ***************************************************************************/
+
+/**
+ * Curvature engine kept by an Object after set_file, of any precision, to update its curvatures when vertices move
+ * (see BasicMeshCurvature::update_vertices). outputs are the arrays of Object::get_cached_arrays, principal the
+ * principal curvatures of the object.
+ */
+class MeshUpdater
+{
+  public:
+    virtual ~MeshUpdater() {}
+    virtual bool update_vertices(const vector<int> &vertices, const vector<Point3d> &new_positions, vector<float> *outputs[CURVATURE_CACHE_ARRAYS], PrincipalCurvatureOutputs &principal, CurvatureUpdate &update) = 0;
+};
+
+template <typename Engine>
+class BasicMeshUpdater : public MeshUpdater
+{
+  public:
+    Engine mesh;
+
+    // takes the mesh, the edges and the values kept by the engine after its load
+    BasicMeshUpdater(Engine &engine) : mesh(std::move(engine))
+    {
+        mesh.progress = NULL;
+    }
+
+    bool update_vertices(const vector<int> &vertices, const vector<Point3d> &new_positions, vector<float> *outputs[CURVATURE_CACHE_ARRAYS], PrincipalCurvatureOutputs &principal, CurvatureUpdate &update)
+    {
+        return mesh.update_vertices(vertices, new_positions, *outputs[0], *outputs[1], *outputs[2], *outputs[3], *outputs[5], *outputs[4], *outputs[6], *outputs[7], *outputs[8], update, &principal);
+    }
+};
+
 class Object
 {
   public:
@@ -30,14 +64,17 @@ class Object
 
     vector<float> triangle_mc_vertex_notduplicatevalue; // vector of mean curvature per vertex of length vertices
 
-    double best_min_gc;
-    double best_max_gc;
+    // principal curvatures k1, k2 and their directions, per corner (uploaded by init) and per vertex (see PrincipalCurvatures.h)
+    PrincipalCurvatureOutputs principal_curvatures;
+
+    double best_min_gc = 0;
+    double best_max_gc = 0;
 
-    double best_min_mc;
-    double best_max_mc;
+    double best_min_mc = 0;
+    double best_max_mc = 0;
 
-    double best_min_mc_vertex;
-    double best_max_mc_vertex;
+    double best_min_mc_vertex = 0;
+    double best_max_mc_vertex = 0;
 
     KPercentile k_percentile_gc = KPercentile();
     KPercentile k_percentile_mc = KPercentile();
@@ -48,9 +85,28 @@ class Object
         VBO: manage this memory via so called vertex buffer objects (VBO) that can store a large number of vertices in the GPU's memory
     */
     unsigned int VBO, VAO, VBO_NORMAL_VERTEX, VBO_NORMAL_TRIANGLE, VBO_GAUSSIANCURVATURE, VBO_MEANCURVATURE, VBO_MEANCURVATURE_VERTEX;
+    unsigned int VBO_PRINCIPAL_CURVATURES, VBO_PRINCIPAL_DIRECTION_1, VBO_PRINCIPAL_DIRECTION_2;
+
+    // if true the results of load() are read from/written to a cache next to the mesh (path + ".curvcache")
+    bool use_curvature_cache = true;
 
-    // Constructor
-    void set_file(const std::string &_path)
+    // engine kept by set_file when use_incremental_updates is true (LoaderObject.h), NULL otherwise: see update_vertices
+    unique_ptr<MeshUpdater> mesh_updater;
+
+    // neighbourhoods found by set_file when use_multiscale_curvature is true (MultiScaleCurvature.h), empty otherwise:
+    // see set_curvature_scale
+    VertexNeighbourhoods curvature_neighbourhoods;
+    vector<int> corner_vertices; // vertex of each corner (3 per triangle), to copy the values per vertex to the buffers
+    double curvature_scale = 0;  // scale of the curvatures in VBO_GAUSSIANCURVATURE and VBO_MEANCURVATURE_VERTEX
+
+    // with use_mesh_reordering, index in the arrays of each vertex and triangle of the mesh as read (see
+    // BasicMeshCurvature::vertex_index), empty otherwise and when set_file reads the curvature cache
+    vector<int> vertex_index;
+    vector<int> triangle_index;
+
+    // Constructor (the format of the mesh, OFF, PLY or OBJ, is found by load)
+    // progress (if not NULL) receives the progress of the load between 0 and 1
+    void set_file(const std::string &_path, atomic<float> *progress = NULL)
     {
         triangle_vertices.clear();
         triangle_normals_per_vertex.clear();
@@ -61,6 +117,7 @@ class Object
         triangle_mc_notduplicatevalue.clear();
         triangle_gc_notduplicatevalue.clear();
         triangle_mc_vertex_notduplicatevalue.clear();
+        principal_curvatures = PrincipalCurvatureOutputs(); // frees the arrays too
 
         triangle_vertices.shrink_to_fit();
         triangle_normals_per_vertex.shrink_to_fit();
@@ -71,32 +128,269 @@ class Object
         triangle_mc_notduplicatevalue.shrink_to_fit();
         triangle_gc_notduplicatevalue.shrink_to_fit();
         triangle_mc_vertex_notduplicatevalue.shrink_to_fit();
+        mesh_updater.reset();
+        curvature_neighbourhoods.clear();
+        vector<int>().swap(corner_vertices);
+        curvature_scale = 0;
+        vector<int>().swap(vertex_index);
+        vector<int>().swap(triangle_index);
+
+        // engine of this load (nothing is shared with other loads), of the precisions chosen in LoaderObject.h
+        FileLoad load = {this, &_path, progress};
+        visit_mesh_curvature(curvature_precision, accumulation_precision, progress, load);
+    }
+
+    // calls load_file with the engine created by visit_mesh_curvature
+    struct FileLoad
+    {
+        Object *object;
+        const std::string *path;
+        atomic<float> *progress;
 
+        template <typename Engine>
+        void operator()(Engine &mesh)
+        {
+            object->load_file(mesh, *path, progress);
+        }
+    };
 
-        if (!load(_path.c_str(), triangle_vertices, triangle_normals_per_vertex, triangle_normals_per_triangle, triangle_gc, triangle_mc, triangle_mc_vertex, triangle_gc_notduplicatevalue, triangle_mc_notduplicatevalue, triangle_mc_vertex_notduplicatevalue))
+    // body of set_file for an engine of any precision
+    template <typename Engine>
+    void load_file(Engine &mesh, const std::string &_path, atomic<float> *progress)
+    {
+        // results already computed for this mesh: go straight to the upload (init)
+        // (not for updates and multi-scale curvatures: the cache has no edges)
+        vector<float> *cached_arrays[CURVATURE_CACHE_ARRAYS];
+        get_cached_arrays(cached_arrays);
+        double bounds[CURVATURE_CACHE_BOUNDS];
+        if (use_curvature_cache && !mesh.use_incremental_updates && !use_multiscale_curvature && read_curvature_cache(_path.c_str(), mesh.get_settings_key(), cached_arrays, bounds))
+        {
+            set_best_values(bounds);
+            if (progress)
+                *progress = 1.0f;
+            cout << "Object loaded from cache" << endl;
+            return;
+        }
+
+        if (!mesh.load(_path.c_str(), triangle_vertices, triangle_normals_per_vertex, triangle_normals_per_triangle, triangle_gc, triangle_mc, triangle_mc_vertex, triangle_gc_notduplicatevalue, triangle_mc_notduplicatevalue, triangle_mc_vertex_notduplicatevalue, &principal_curvatures))
         {
             cout << "error loading file" << endl;
             return;
         }
+        vertex_index = mesh.vertex_index;
+        triangle_index = mesh.triangle_index;
+        if (use_multiscale_curvature)
+        {
+            build_vertex_neighbourhoods(mesh.t, mesh.positions, mesh.vertex_adjacency, multiscale_neighbourhood, get_multiscale_max_scale(), curvature_neighbourhoods, mesh.threads);
+            corner_vertices.resize((size_t)mesh.num_triangles * 3);
+            for (int k = 0; k < mesh.num_triangles; k++)
+                for (int j = 0; j < 3; j++)
+                    corner_vertices[(size_t)k * 3 + j] = mesh.t[k].v[j];
+        }
+        if (mesh.use_incremental_updates)
+            mesh_updater.reset(new BasicMeshUpdater<Engine>(mesh));
+
+        compute_best_values();
+
+        if (use_curvature_cache)
+        {
+            get_best_values(bounds);
+            if (!write_curvature_cache(_path.c_str(), mesh.get_settings_key(), cached_arrays, bounds))
+                cout << "Curvature cache not written for " << _path << endl;
+        }
+        if (progress)
+            *progress = 1.0f;
     }
 
-    // Function to initialize VBO and VAO
-    // name file and the second it is the method gc
-    void init()
+    /**
+     * k-percentile bounds of the values per vertex and per edge. KPercentile::init sorts its array: it gets copies,
+     * the values stay indexed by vertex and edge for set_curvature_scale and update_vertices.
+     */
+    void compute_best_values()
     {
-        vector<double> percentiles_gc = k_percentile_gc.init(triangle_gc_notduplicatevalue);
+        compute_best_values(triangle_gc_notduplicatevalue, triangle_mc_vertex_notduplicatevalue);
+    }
+
+    // k-percentile bounds with the given Gaussian and mean curvature per vertex (the values of a scale, see compute_curvature_scale)
+    void compute_best_values(const vector<float> &gc_vertex, const vector<float> &mc_vertex)
+    {
+        vector<float> values(gc_vertex);
+        vector<double> percentiles_gc = k_percentile_gc.init(values);
         best_min_gc = percentiles_gc[0];
         best_max_gc = percentiles_gc[1];
 
-        vector<double> percentiles_mc_edge = k_percentile_mc.init(triangle_mc_notduplicatevalue);
+        values = triangle_mc_notduplicatevalue;
+        vector<double> percentiles_mc_edge = k_percentile_mc.init(values);
         best_min_mc = percentiles_mc_edge[0];
         best_max_mc = percentiles_mc_edge[1];
 
-
-        vector<double> percentiles_mc_vertex = k_percentile_mc_vertex.init(triangle_mc_vertex_notduplicatevalue);
+        values = mc_vertex;
+        vector<double> percentiles_mc_vertex = k_percentile_mc_vertex.init(values);
         best_min_mc_vertex = percentiles_mc_vertex[0];
         best_max_mc_vertex = percentiles_mc_vertex[1];
+    }
 
+    // arrays saved in the curvature cache: the buffers in the order of the uploads of init, then the values per vertex/triangle
+    void get_cached_arrays(vector<float> *arrays[CURVATURE_CACHE_ARRAYS])
+    {
+        arrays[0] = &triangle_vertices;
+        arrays[1] = &triangle_normals_per_vertex;
+        arrays[2] = &triangle_normals_per_triangle;
+        arrays[3] = &triangle_gc;
+        arrays[4] = &triangle_mc_vertex;
+        arrays[5] = &triangle_mc;
+        arrays[6] = &triangle_gc_notduplicatevalue;
+        arrays[7] = &triangle_mc_notduplicatevalue;
+        arrays[8] = &triangle_mc_vertex_notduplicatevalue;
+        arrays[9] = &principal_curvatures.curvatures;
+        arrays[10] = &principal_curvatures.directions_1;
+        arrays[11] = &principal_curvatures.directions_2;
+        arrays[12] = &principal_curvatures.curvatures_vertex;
+        arrays[13] = &principal_curvatures.directions_vertex;
+    }
+
+    // k-percentile bounds saved in the curvature cache
+    void get_best_values(double bounds[CURVATURE_CACHE_BOUNDS])
+    {
+        bounds[0] = best_min_gc;
+        bounds[1] = best_max_gc;
+        bounds[2] = best_min_mc;
+        bounds[3] = best_max_mc;
+        bounds[4] = best_min_mc_vertex;
+        bounds[5] = best_max_mc_vertex;
+    }
+
+    void set_best_values(const double bounds[CURVATURE_CACHE_BOUNDS])
+    {
+        best_min_gc = bounds[0];
+        best_max_gc = bounds[1];
+        best_min_mc = bounds[2];
+        best_max_mc = bounds[3];
+        best_min_mc_vertex = bounds[4];
+        best_max_mc_vertex = bounds[5];
+    }
+
+    // exchange the results of set_file with another object (the GL buffers are not touched)
+    void swap_data(Object &other)
+    {
+        vector<float> *arrays[CURVATURE_CACHE_ARRAYS], *other_arrays[CURVATURE_CACHE_ARRAYS];
+        get_cached_arrays(arrays);
+        other.get_cached_arrays(other_arrays);
+        for (int i = 0; i < CURVATURE_CACHE_ARRAYS; i++)
+            arrays[i]->swap(*other_arrays[i]);
+
+        double bounds[CURVATURE_CACHE_BOUNDS], other_bounds[CURVATURE_CACHE_BOUNDS];
+        get_best_values(bounds);
+        other.get_best_values(other_bounds);
+        set_best_values(other_bounds);
+        other.set_best_values(bounds);
+        mesh_updater.swap(other.mesh_updater);
+        std::swap(curvature_neighbourhoods, other.curvature_neighbourhoods);
+        corner_vertices.swap(other.corner_vertices);
+        std::swap(curvature_scale, other.curvature_scale);
+        vertex_index.swap(other.vertex_index);
+        triangle_index.swap(other.triangle_index);
+    }
+
+    /**
+     * Show the Gaussian and the mean curvature per vertex averaged over the neighbourhoods of scale (rings or radius,
+     * see MultiScaleCurvature.h; 0 gives the values of load()): only the averages are computed, the neighbourhoods were
+     * found by set_file. Only after set_file with use_multiscale_curvature and init, on the thread of the GL context.
+     * The k-percentile bounds (get_best_values_gc, get_best_values_mc_vertex) are the ones of the values of scale: the
+     * caller sets them in the shader again. update_vertices writes the values of scale 0 around the moved vertices
+     * and their bounds (call it again after them).
+     * Return false if the object has no neighbourhoods or scale is bigger than their scale.
+     */
+    bool set_curvature_scale(double scale)
+    {
+        if (!compute_curvature_scale(scale))
+            return false;
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_GAUSSIANCURVATURE);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float) * triangle_gc.size(), triangle_gc.data());
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_MEANCURVATURE_VERTEX);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float) * triangle_mc_vertex.size(), triangle_mc_vertex.data());
+        return true;
+    }
+
+    // arrays of set_curvature_scale (triangle_gc and triangle_mc_vertex) and their k-percentile bounds, without the upload
+    bool compute_curvature_scale(double scale)
+    {
+        if (curvature_neighbourhoods.vertices_count() == 0)
+        {
+            cout << "The object was not loaded with use_multiscale_curvature." << endl;
+            return false;
+        }
+
+        const vector<float> *values[] = {&triangle_gc_notduplicatevalue, &triangle_mc_vertex_notduplicatevalue};
+        vector<vector<float> > scaled;
+        if (!evaluate_multiscale_curvature(curvature_neighbourhoods, values, 2, vector<double>(1, scale), scaled, loader_threads))
+            return false;
+
+        // values per corner as in load(): 3 times the value of the vertex
+        for (size_t corner = 0; corner < corner_vertices.size(); corner++)
+            for (int i = 0; i < 3; i++)
+            {
+                triangle_gc[corner * 3 + i] = scaled[0][corner_vertices[corner]];
+                triangle_mc_vertex[corner * 3 + i] = scaled[1][corner_vertices[corner]];
+            }
+        compute_best_values(scaled[0], scaled[1]);
+        curvature_scale = scale;
+        return true;
+    }
+
+    /**
+     * Move vertices (new positions in the coords of triangle_vertices) and update the curvatures around them, then the
+     * ranges of the GL buffers of the changed triangles (close ranges are merged, see get_index_ranges): the time of
+     * the curvatures and of the uploads depends on the size of the edit, not of the mesh. Only after set_file with use_incremental_updates and init,
+     * on the thread of the GL context. The k-percentile bounds are computed again on the updated values.
+     * The vertices are indices in the arrays (vertex vertex_index[i] for vertex i of the file with use_mesh_reordering).
+     * Return false if the object cannot be updated (see BasicMeshCurvature::update_vertices).
+     */
+    bool update_vertices(const vector<int> &vertices, const vector<Point3d> &new_positions)
+    {
+        CurvatureUpdate update;
+        if (!update_vertex_data(vertices, new_positions, update))
+            return false;
+
+        vector<float> *arrays[CURVATURE_CACHE_ARRAYS];
+        get_cached_arrays(arrays);
+
+        // buffers of init, uploaded from arrays[0] ... arrays[5], arrays[10], arrays[11] (9 floats per triangle) and arrays[9] (6 floats)
+        unsigned int buffers[] = {VBO, VBO_NORMAL_VERTEX, VBO_NORMAL_TRIANGLE, VBO_GAUSSIANCURVATURE, VBO_MEANCURVATURE_VERTEX, VBO_MEANCURVATURE,
+                                  VBO_PRINCIPAL_DIRECTION_1, VBO_PRINCIPAL_DIRECTION_2, VBO_PRINCIPAL_CURVATURES};
+        int buffer_arrays[] = {0, 1, 2, 3, 4, 5, 10, 11, 9};
+        vector<pair<int, int> > ranges;
+        get_index_ranges(update.triangles, UPDATE_RANGE_MAX_GAP, ranges);
+        for (int i = 0; i < 9; i++)
+        {
+            size_t floats = buffer_arrays[i] == 9 ? 6 : 9; // per triangle
+            glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+            for (size_t r = 0; r < ranges.size(); r++)
+                glBufferSubData(GL_ARRAY_BUFFER, sizeof(float) * floats * ranges[r].first, sizeof(float) * floats * (ranges[r].second - ranges[r].first), &(*arrays[buffer_arrays[i]])[(size_t)ranges[r].first * floats]);
+        }
+        return true;
+    }
+
+    // arrays of update_vertices and their k-percentile bounds, without the upload; update receives the changed triangles
+    bool update_vertex_data(const vector<int> &vertices, const vector<Point3d> &new_positions, CurvatureUpdate &update)
+    {
+        if (!mesh_updater)
+        {
+            cout << "The object was not loaded with use_incremental_updates." << endl;
+            return false;
+        }
+
+        vector<float> *arrays[CURVATURE_CACHE_ARRAYS];
+        get_cached_arrays(arrays);
+        if (!mesh_updater->update_vertices(vertices, new_positions, arrays, principal_curvatures, update))
+            return false;
+        compute_best_values();
+        return true;
+    }
+
+    // Function to initialize VBO and VAO (the percentiles are computed by set_file)
+    void init()
+    {
         // ------------- VBO -------------
         // Use VBO to avoid to send data vertex at a time (we send everything together)
         glGenBuffers(1, &VBO); //generate buffer, bufferID = 1
@@ -108,14 +402,15 @@ class Object
               GL_DYNAMIC_DRAW: the data is likely to change a lot.
               GL_STREAM_DRAW: the data will change every time it is drawn.
           */
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_vertices.size(), &triangle_vertices[0], GL_STATIC_DRAW); // copies the previously defined vertex data into the buffer's memor
+        GLenum usage = mesh_updater || !corner_vertices.empty() ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW; // changed by update_vertices, set_curvature_scale
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_vertices.size(), &triangle_vertices[0], usage); // copies the previously defined vertex data into the buffer's memor
 
         // VBO NORMALS VERTEX
         glGenBuffers(1, &VBO_NORMAL_VERTEX); //generate buffer, bufferID = 1
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO_NORMAL_VERTEX);
 
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_normals_per_vertex.size(), &triangle_normals_per_vertex[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_normals_per_vertex.size(), &triangle_normals_per_vertex[0], usage);
 
 
         // VBO NORMALS TRIANGLE
@@ -123,7 +418,7 @@ class Object
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO_NORMAL_TRIANGLE);
 
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_normals_per_triangle.size(), &triangle_normals_per_triangle[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_normals_per_triangle.size(), &triangle_normals_per_triangle[0], usage);
 
 
         // VBO_GAUSSIANCURVATURE
@@ -131,14 +426,14 @@ class Object
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO_GAUSSIANCURVATURE);
 
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_gc.size(), &triangle_gc[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_gc.size(), &triangle_gc[0], usage);
 
         // VBO_MEANCURVATURE_VERTEX
         glGenBuffers(1, &VBO_MEANCURVATURE_VERTEX); //generate buffer, bufferID = 1
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO_MEANCURVATURE_VERTEX);
 
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_mc_vertex.size(), &triangle_mc_vertex[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_mc_vertex.size(), &triangle_mc_vertex[0], usage);
 
 
         // VBO_MEANCURVATURE
@@ -146,7 +441,20 @@ class Object
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO_MEANCURVATURE);
 
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_mc.size(), &triangle_mc[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triangle_mc.size(), &triangle_mc[0], usage);
+
+        // VBO_PRINCIPAL_CURVATURES (k1, k2), VBO_PRINCIPAL_DIRECTION_1, VBO_PRINCIPAL_DIRECTION_2
+        glGenBuffers(1, &VBO_PRINCIPAL_CURVATURES);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_PRINCIPAL_CURVATURES);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * principal_curvatures.curvatures.size(), principal_curvatures.curvatures.data(), usage);
+
+        glGenBuffers(1, &VBO_PRINCIPAL_DIRECTION_1);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_PRINCIPAL_DIRECTION_1);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * principal_curvatures.directions_1.size(), principal_curvatures.directions_1.data(), usage);
+
+        glGenBuffers(1, &VBO_PRINCIPAL_DIRECTION_2);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_PRINCIPAL_DIRECTION_2);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * principal_curvatures.directions_2.size(), principal_curvatures.directions_2.data(), usage);
 
         // ------------- VAO -------------
         glGenVertexArrays(1, &VAO);
@@ -201,6 +509,19 @@ class Object
         glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)(0 * sizeof(float)));
         glEnableVertexAttribArray(4); //this 4 is referred to the layout on shader
 
+        // principal curvatures (vec2: k1, k2) and directions
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_PRINCIPAL_CURVATURES);
+        glVertexAttribPointer(6, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)(0 * sizeof(float)));
+        glEnableVertexAttribArray(6); //this 6 is referred to the layout on shader
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_PRINCIPAL_DIRECTION_1);
+        glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)(0 * sizeof(float)));
+        glEnableVertexAttribArray(7); //this 7 is referred to the layout on shader
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_PRINCIPAL_DIRECTION_2);
+        glVertexAttribPointer(8, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)(0 * sizeof(float)));
+        glEnableVertexAttribArray(8); //this 8 is referred to the layout on shader
+
 
         /**
             Unbind the VAO so other VAO calls won't accidentally modify this VAO, but this rarely happens.
@@ -237,9 +558,13 @@ class Object
         glDeleteVertexArrays(1, &VAO);
         glDeleteBuffers(1, &VBO);
         glDeleteBuffers(1, &VBO_NORMAL_VERTEX);
+        glDeleteBuffers(1, &VBO_NORMAL_TRIANGLE);
         glDeleteBuffers(1, &VBO_GAUSSIANCURVATURE);
         glDeleteBuffers(1, &VBO_MEANCURVATURE);
         glDeleteBuffers(1, &VBO_MEANCURVATURE_VERTEX);
+        glDeleteBuffers(1, &VBO_PRINCIPAL_CURVATURES);
+        glDeleteBuffers(1, &VBO_PRINCIPAL_DIRECTION_1);
+        glDeleteBuffers(1, &VBO_PRINCIPAL_DIRECTION_2);
     }
 
     /**
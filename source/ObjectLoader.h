@@ -0,0 +1,109 @@
+#ifndef OBJECTLOADER_H
+#define OBJECTLOADER_H
+
+#include "Object.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+/***************************************************************************
+ObjectLoader.h
+Comment:  This file loads an Object on a worker thread while the current one is rendered.
+***************************************************************************/
+
+/**
+ * Object::set_file (reading, curvatures, percentiles) runs on a worker thread, the render loop polls is_finished()
+ * and then take() moves the results into the rendered Object. Only the CPU side is done by the worker:
+ * the GL upload (Object::init) stays on the main thread, which owns the GL context.
+ * A loader loads one mesh at a time; set_file uses its own MeshCurvature, so several loaders can run together.
+ */
+class ObjectLoader
+{
+  public:
+    ObjectLoader() : progress(0.0f), is_running(false), is_done(false) {}
+
+    ~ObjectLoader()
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+
+    /**
+     * Start loading the mesh at path. Return false if another mesh is being loaded.
+     */
+    bool start(const std::string &path)
+    {
+        if (is_running)
+            return false;
+
+        is_running = true;
+        is_done = false;
+        progress = 0.0f;
+        loading_path = path;
+        worker = std::thread([this]() {
+            loaded.set_file(loading_path, &progress);
+            is_done = true;
+        });
+        return true;
+    }
+
+    /**
+     * True from start() until take().
+     */
+    bool is_loading() const
+    {
+        return is_running;
+    }
+
+    /**
+     * True when the worker has finished and take() does not wait.
+     */
+    bool is_finished() const
+    {
+        return is_running && is_done;
+    }
+
+    float get_progress() const
+    {
+        return progress;
+    }
+
+    const std::string &get_path() const
+    {
+        return loading_path;
+    }
+
+    /**
+     * Wait for the worker and move the loaded mesh into object (its GL buffers are not touched, call init after).
+     * Return false if the mesh could not be loaded: object is not changed.
+     */
+    bool take(Object &object)
+    {
+        if (!is_running)
+            return false;
+        worker.join();
+        is_running = false;
+
+        if (loaded.triangle_vertices.empty())
+            return false;
+        object.swap_data(loaded);
+
+        Object empty; // free the previous mesh
+        loaded.swap_data(empty);
+        return true;
+    }
+
+  private:
+    // a worker cannot be shared between two objects
+    ObjectLoader(const ObjectLoader &);
+    ObjectLoader &operator=(const ObjectLoader &);
+
+    Object loaded;
+    std::string loading_path;
+    std::thread worker;
+    std::atomic<float> progress; // progress of set_file between 0 and 1
+    bool is_running;
+    std::atomic<bool> is_done;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+/***************************************************************************
+ParallelFor.h
+Comment:  This file runs a loop over many items with many threads.
+***************************************************************************/
+
+/**
+ * The items 0 ... count - 1 are split in one contiguous range for each thread, so a loop that writes only
+ * the slots of its own items (values per corner, per edge or per vertex) needs no lock and no atomic:
+ * every value is computed by one thread, with the same operations in the same order as in a serial loop,
+ * and the results do not depend on the number of threads.
+ */
+
+// loops with fewer items than this run on the calling thread
+const int PARALLEL_FOR_MIN_ITEMS = 4096;
+
+/**
+ * Number of threads to use for threads_count (0: one thread for each core).
+ */
+inline int get_threads_count(int threads_count)
+{
+    if (threads_count <= 0)
+        return std::max(1u, std::thread::hardware_concurrency());
+    return threads_count;
+}
+
+/**
+ * Call function(begin, end) for each range of items, every range on its own thread (the first one on the calling thread).
+ */
+template <typename Function>
+void parallel_for(int count, int threads_count, Function function, int min_items = PARALLEL_FOR_MIN_ITEMS)
+{
+    threads_count = std::min(get_threads_count(threads_count), std::max(1, count / std::max(1, min_items)));
+    if (threads_count <= 1)
+    {
+        function(0, count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads_count; i++)
+        workers.push_back(std::thread(function, (int)((long)count * i / threads_count), (int)((long)count * (i + 1) / threads_count)));
+    function(0, (int)((long)count / threads_count));
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+}
+
+#endif
@@ -0,0 +1,602 @@
+#ifndef PLYREADER_H
+#define PLYREADER_H
+
+#include "Point3.h"
+#include "MeshTokenizer.h"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+/***************************************************************************
+PlyReader.h
+Comment:  This file contains a reader of PLY files (ascii, binary little endian and binary big endian).
+***************************************************************************/
+
+/**
+ * Only the x y z properties of the "vertex" element and the first list property of the "face" element
+ * (vertex_indices) are read, every other element and property is skipped.
+ * Polygons are triangulated as a fan around their first vertex: the faces are the first triangles of out_t,
+ * the other triangles of the polygons follow them, as in the OFF reader.
+ * Binary files are not parsed: vertices and faces are copied from their fixed offsets in each record,
+ * and when the layout of the file is the layout of the arrays (double x y z, triangles of int32) with one memcpy.
+ */
+enum PlyType
+{
+    PLY_INVALID,
+    PLY_CHAR,
+    PLY_UCHAR,
+    PLY_SHORT,
+    PLY_USHORT,
+    PLY_INT,
+    PLY_UINT,
+    PLY_FLOAT,
+    PLY_DOUBLE
+};
+
+enum PlyFormat
+{
+    PLY_ASCII,
+    PLY_BINARY_LITTLE_ENDIAN,
+    PLY_BINARY_BIG_ENDIAN
+};
+
+struct PlyProperty
+{
+    std::string name;
+    PlyType type;       // type of the value (of the items for a list)
+    bool is_list;       // true for "property list <count type> <item type> <name>"
+    PlyType count_type; // type of the number of items of a list
+};
+
+struct PlyElement
+{
+    std::string name;
+    size_t count;
+    std::vector<PlyProperty> properties;
+};
+
+struct PlyHeader
+{
+    PlyFormat format;
+    std::vector<PlyElement> elements;
+};
+
+/**
+ * Type of a property from its name in the header.
+ */
+inline PlyType get_ply_type(const std::string &name)
+{
+    if (name == "char" || name == "int8")
+        return PLY_CHAR;
+    if (name == "uchar" || name == "uint8")
+        return PLY_UCHAR;
+    if (name == "short" || name == "int16")
+        return PLY_SHORT;
+    if (name == "ushort" || name == "uint16")
+        return PLY_USHORT;
+    if (name == "int" || name == "int32")
+        return PLY_INT;
+    if (name == "uint" || name == "uint32")
+        return PLY_UINT;
+    if (name == "float" || name == "float32")
+        return PLY_FLOAT;
+    if (name == "double" || name == "float64")
+        return PLY_DOUBLE;
+    return PLY_INVALID;
+}
+
+/**
+ * Size in bytes of a value in binary files.
+ */
+inline size_t get_ply_type_size(PlyType type)
+{
+    static const size_t sizes[] = {0, 1, 1, 2, 2, 4, 4, 4, 8};
+    return sizes[type];
+}
+
+/**
+ * Read a binary value of the given type (bytes swapped for big endian files on little endian CPUs).
+ */
+inline double read_ply_value(const char *p, PlyType type, bool is_swapped)
+{
+    unsigned char bytes[8];
+    size_t size = get_ply_type_size(type);
+    memcpy(bytes, p, size);
+    if (is_swapped)
+        for (size_t i = 0; i < size / 2; i++)
+            std::swap(bytes[i], bytes[size - 1 - i]);
+
+    switch (type)
+    {
+    case PLY_CHAR:
+        return (int8_t)bytes[0];
+    case PLY_UCHAR:
+        return bytes[0];
+    case PLY_SHORT:
+    {
+        int16_t value;
+        memcpy(&value, bytes, 2);
+        return value;
+    }
+    case PLY_USHORT:
+    {
+        uint16_t value;
+        memcpy(&value, bytes, 2);
+        return value;
+    }
+    case PLY_INT:
+    {
+        int32_t value;
+        memcpy(&value, bytes, 4);
+        return value;
+    }
+    case PLY_UINT:
+    {
+        uint32_t value;
+        memcpy(&value, bytes, 4);
+        return value;
+    }
+    case PLY_FLOAT:
+    {
+        float value;
+        memcpy(&value, bytes, 4);
+        return value;
+    }
+    case PLY_DOUBLE:
+    {
+        double value;
+        memcpy(&value, bytes, 8);
+        return value;
+    }
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Parse the header of a PLY file. data is moved at the first byte after "end_header\n".
+ */
+inline bool parse_ply_header(const char *&data, const char *end, PlyHeader &header)
+{
+    bool has_format = false;
+    bool is_first_line = true;
+    while (data < end)
+    {
+        const char *line_end = (const char *)memchr(data, '\n', end - data);
+        if (!line_end)
+            break;
+        std::istringstream line(std::string(data, line_end));
+        data = line_end + 1;
+
+        std::string keyword;
+        line >> keyword;
+        if (is_first_line)
+        {
+            if (keyword != "ply")
+            {
+                std::cout << "This is not a valid PLY file." << std::endl;
+                return false;
+            }
+            is_first_line = false;
+        }
+        else if (keyword == "format")
+        {
+            std::string format;
+            line >> format;
+            if (format == "ascii")
+                header.format = PLY_ASCII;
+            else if (format == "binary_little_endian")
+                header.format = PLY_BINARY_LITTLE_ENDIAN;
+            else if (format == "binary_big_endian")
+                header.format = PLY_BINARY_BIG_ENDIAN;
+            else
+            {
+                std::cout << "Unknown PLY format " << format << std::endl;
+                return false;
+            }
+            has_format = true;
+        }
+        else if (keyword == "element")
+        {
+            PlyElement element;
+            if (!(line >> element.name >> element.count))
+            {
+                std::cout << "Invalid PLY element." << std::endl;
+                return false;
+            }
+            header.elements.push_back(element);
+        }
+        else if (keyword == "property")
+        {
+            PlyProperty property;
+            std::string type;
+            line >> type;
+            property.is_list = (type == "list");
+            property.count_type = PLY_INVALID;
+            if (property.is_list)
+            {
+                std::string count_type;
+                line >> count_type >> type;
+                property.count_type = get_ply_type(count_type);
+            }
+            property.type = get_ply_type(type);
+            line >> property.name;
+            if (header.elements.empty() || property.type == PLY_INVALID || (property.is_list && property.count_type == PLY_INVALID))
+            {
+                std::cout << "Invalid PLY property " << property.name << std::endl;
+                return false;
+            }
+            header.elements.back().properties.push_back(property);
+        }
+        else if (keyword == "end_header")
+        {
+            if (!has_format)
+                std::cout << "PLY file without format." << std::endl;
+            return has_format;
+        }
+        // comment, obj_info: ignored
+    }
+    std::cout << "PLY header without end_header." << std::endl;
+    return false;
+}
+
+/**
+ * Index of the property with the given name, -1 if it is not in the element.
+ */
+inline int get_ply_property(const PlyElement &element, const char *name)
+{
+    for (size_t i = 0; i < element.properties.size(); i++)
+        if (element.properties[i].name == name)
+            return i;
+    return -1;
+}
+
+/**
+ * Read a binary vertex index, -1 (an invalid index) if it is out of the range of int.
+ */
+inline int read_ply_index(const char *p, PlyType type, bool is_swapped)
+{
+    double value = read_ply_value(p, type, is_swapped);
+    return value >= 0 && value <= INT_MAX ? (int)value : -1;
+}
+
+/**
+ * Index of the list property with the indices of the vertices of a face, -1 if there is none.
+ */
+inline int get_ply_face_property(const PlyElement &element)
+{
+    for (size_t i = 0; i < element.properties.size(); i++)
+        if (element.properties[i].is_list && (element.properties[i].name == "vertex_indices" || element.properties[i].name == "vertex_index"))
+            return i;
+    return -1;
+}
+
+/**
+ * Size of the records of an element in a binary file, 0 if the records have lists (variable size).
+ */
+inline size_t get_ply_record_size(const PlyElement &element)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < element.properties.size(); i++)
+    {
+        if (element.properties[i].is_list)
+            return 0;
+        size += get_ply_type_size(element.properties[i].type);
+    }
+    return size;
+}
+
+/**
+ * Read the vertices of a binary file. Every vertex is a record of fixed size: x y z are read at their offsets.
+ */
+inline bool read_ply_binary_vertices(const char *&data, const char *end, const PlyElement &element, bool is_swapped, std::vector<Point3d> &out_v)
+{
+    size_t record_size = get_ply_record_size(element);
+    int coordinates[3] = {get_ply_property(element, "x"), get_ply_property(element, "y"), get_ply_property(element, "z")};
+    if (record_size == 0 || coordinates[0] < 0 || coordinates[1] < 0 || coordinates[2] < 0)
+    {
+        std::cout << "Unsupported PLY vertex element." << std::endl;
+        return false;
+    }
+    if ((size_t)(end - data) / record_size < element.count)
+    {
+        std::cout << "PLY file too short for its vertices." << std::endl;
+        return false;
+    }
+
+    size_t offsets[3];
+    PlyType types[3];
+    for (int j = 0; j < 3; j++)
+    {
+        offsets[j] = 0;
+        for (int i = 0; i < coordinates[j]; i++)
+            offsets[j] += get_ply_type_size(element.properties[i].type);
+        types[j] = element.properties[coordinates[j]].type;
+    }
+
+    out_v.resize(element.count);
+    if (!is_swapped && record_size == sizeof(Point3d) && offsets[0] == 0 && offsets[1] == 8 && offsets[2] == 16 &&
+        types[0] == PLY_DOUBLE && types[1] == PLY_DOUBLE && types[2] == PLY_DOUBLE)
+    {
+        if (element.count > 0)
+            memcpy(&out_v[0], data, element.count * record_size); // same layout as Point3d
+    }
+    else if (!is_swapped && types[0] == PLY_FLOAT && types[1] == PLY_FLOAT && types[2] == PLY_FLOAT)
+    {
+        for (size_t i = 0; i < element.count; i++)
+        {
+            const char *record = data + i * record_size;
+            float x, y, z;
+            memcpy(&x, record + offsets[0], 4);
+            memcpy(&y, record + offsets[1], 4);
+            memcpy(&z, record + offsets[2], 4);
+            out_v[i].setCoords(x, y, z);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < element.count; i++)
+        {
+            const char *record = data + i * record_size;
+            out_v[i].setCoords(read_ply_value(record + offsets[0], types[0], is_swapped), read_ply_value(record + offsets[1], types[1], is_swapped),
+                               read_ply_value(record + offsets[2], types[2], is_swapped));
+        }
+    }
+    data += element.count * record_size;
+    return true;
+}
+
+/**
+ * Skip the records of an element of a binary file.
+ */
+inline bool skip_ply_binary_element(const char *&data, const char *end, const PlyElement &element, bool is_swapped)
+{
+    size_t record_size = get_ply_record_size(element);
+    if (record_size > 0)
+    {
+        if ((size_t)(end - data) / record_size < element.count)
+            return false;
+        data += element.count * record_size;
+        return true;
+    }
+
+    for (size_t i = 0; i < element.count; i++)
+    {
+        for (size_t j = 0; j < element.properties.size(); j++)
+        {
+            const PlyProperty &property = element.properties[j];
+            if (!property.is_list)
+            {
+                data += get_ply_type_size(property.type);
+                continue;
+            }
+            if (end - data < (ptrdiff_t)get_ply_type_size(property.count_type))
+                return false;
+            size_t items = (size_t)read_ply_value(data, property.count_type, is_swapped);
+            data += get_ply_type_size(property.count_type) + items * get_ply_type_size(property.type);
+        }
+        if (data > end)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Read the faces of a binary file. The common layout (only "list uchar int vertex_indices" and only triangles)
+ * has records of 13 bytes: the 3 indices are copied with one memcpy per face.
+ */
+template <typename TriangleType>
+bool read_ply_binary_faces(const char *&data, const char *end, const PlyElement &element, bool is_swapped, std::vector<TriangleType> &out_t)
+{
+    int indices_property = get_ply_face_property(element);
+    if (indices_property < 0)
+    {
+        std::cout << "PLY face element without vertex_indices." << std::endl;
+        return false;
+    }
+    out_t.resize(element.count);
+
+    const PlyProperty &indices = element.properties[indices_property];
+    bool is_triangle_layout = element.properties.size() == 1 && !is_swapped && indices.count_type == PLY_UCHAR && (indices.type == PLY_INT || indices.type == PLY_UINT);
+    if (is_triangle_layout && (size_t)(end - data) / 13 >= element.count)
+    {
+        size_t i = 0;
+        for (; i < element.count && data[i * 13] == 3; i++)
+            memcpy(out_t[i].v, data + i * 13 + 1, 3 * sizeof(int32_t));
+        if (i == element.count)
+        {
+            data += element.count * 13;
+            return true;
+        }
+        // a polygon: read everything with the general code
+    }
+
+    std::vector<TriangleType> polygon_triangles;
+    for (size_t i = 0; i < element.count; i++)
+    {
+        for (size_t j = 0; j < element.properties.size(); j++)
+        {
+            const PlyProperty &property = element.properties[j];
+            if (!property.is_list)
+            {
+                data += get_ply_type_size(property.type);
+                continue;
+            }
+            if (end - data < (ptrdiff_t)get_ply_type_size(property.count_type))
+            {
+                std::cout << "PLY file too short for its faces." << std::endl;
+                return false;
+            }
+            size_t items = (size_t)read_ply_value(data, property.count_type, is_swapped);
+            data += get_ply_type_size(property.count_type);
+            size_t item_size = get_ply_type_size(property.type);
+            if ((size_t)(end - data) < items * item_size)
+            {
+                std::cout << "PLY file too short for its faces." << std::endl;
+                return false;
+            }
+            if ((int)j == indices_property)
+            {
+                if (items < 3)
+                {
+                    std::cout << "Invalid face " << i << " in PLY file." << std::endl;
+                    return false;
+                }
+                for (int k = 0; k < 3; k++)
+                    out_t[i].v[k] = read_ply_index(data + k * item_size, property.type, is_swapped);
+                TriangleType fan = out_t[i];
+                for (size_t k = 3; k < items; k++)
+                {
+                    fan.v[1] = fan.v[2];
+                    fan.v[2] = read_ply_index(data + k * item_size, property.type, is_swapped);
+                    polygon_triangles.push_back(fan);
+                }
+            }
+            data += items * item_size;
+        }
+    }
+    out_t.insert(out_t.end(), polygon_triangles.begin(), polygon_triangles.end());
+    return true;
+}
+
+/**
+ * Read the records of an element of an ascii file: vertices into out_v, faces into out_t, other elements skipped.
+ */
+template <typename TriangleType>
+bool read_ply_ascii_element(MeshTokenizer &tokenizer, const PlyElement &element, std::vector<Point3d> &out_v, std::vector<TriangleType> &out_t)
+{
+    bool is_vertex = element.name == "vertex";
+    bool is_face = element.name == "face";
+    int coordinates[3] = {get_ply_property(element, "x"), get_ply_property(element, "y"), get_ply_property(element, "z")};
+    int indices_property = get_ply_face_property(element);
+    if (is_vertex && (coordinates[0] < 0 || coordinates[1] < 0 || coordinates[2] < 0))
+    {
+        std::cout << "Unsupported PLY vertex element." << std::endl;
+        return false;
+    }
+    if (is_face && indices_property < 0)
+    {
+        std::cout << "PLY face element without vertex_indices." << std::endl;
+        return false;
+    }
+
+    if (is_vertex)
+        out_v.resize(element.count);
+    if (is_face)
+        out_t.resize(element.count);
+
+    const char *token_begin, *token_end;
+    double values[3] = {0, 0, 0};
+    std::vector<TriangleType> polygon_triangles;
+    for (size_t i = 0; i < element.count; i++)
+    {
+        for (size_t j = 0; j < element.properties.size(); j++)
+        {
+            const PlyProperty &property = element.properties[j];
+            if (property.is_list)
+            {
+                int items;
+                if (!tokenizer.next_int(items) || items < 0 || (is_face && (int)j == indices_property && items < 3))
+                {
+                    std::cout << "Invalid " << element.name << " " << i << " in PLY file." << std::endl;
+                    return false;
+                }
+                bool is_indices = is_face && (int)j == indices_property;
+                TriangleType fan;
+                for (int k = 0; k < items; k++)
+                {
+                    bool is_read;
+                    if (is_indices && k < 3)
+                        is_read = tokenizer.next_int(out_t[i].v[k]);
+                    else if (is_indices) // polygon: [v0, v2, v3], [v0, v3, v4] ...
+                    {
+                        if (k == 3)
+                            fan = out_t[i];
+                        fan.v[1] = fan.v[2];
+                        is_read = tokenizer.next_int(fan.v[2]);
+                        polygon_triangles.push_back(fan);
+                    }
+                    else
+                        is_read = tokenizer.next_token(token_begin, token_end);
+                    if (!is_read)
+                    {
+                        std::cout << "Invalid " << element.name << " " << i << " in PLY file." << std::endl;
+                        return false;
+                    }
+                }
+            }
+            else if (is_vertex && ((int)j == coordinates[0] || (int)j == coordinates[1] || (int)j == coordinates[2]))
+            {
+                int coordinate = (int)j == coordinates[0] ? 0 : ((int)j == coordinates[1] ? 1 : 2);
+                if (!tokenizer.next_double(values[coordinate]))
+                {
+                    std::cout << "Invalid vertex " << i << " in PLY file." << std::endl;
+                    return false;
+                }
+            }
+            else if (!tokenizer.next_token(token_begin, token_end))
+            {
+                std::cout << "Invalid " << element.name << " " << i << " in PLY file." << std::endl;
+                return false;
+            }
+        }
+        if (is_vertex)
+            out_v[i].setCoords(values[0], values[1], values[2]);
+    }
+    if (is_face)
+        out_t.insert(out_t.end(), polygon_triangles.begin(), polygon_triangles.end());
+    return true;
+}
+
+/**
+ * Parse the bytes of a PLY file and fill out_v and out_t.
+ */
+template <typename TriangleType>
+bool parse_ply_buffer(const char *begin, const char *end, std::vector<Point3d> &out_v, std::vector<TriangleType> &out_t)
+{
+    PlyHeader header;
+    const char *data = begin;
+    if (!parse_ply_header(data, end, header))
+        return false;
+
+    out_v.clear();
+    out_t.clear();
+    if (header.format == PLY_ASCII)
+    {
+        MeshTokenizer tokenizer(data, end);
+        for (size_t i = 0; i < header.elements.size(); i++)
+            if (!read_ply_ascii_element(tokenizer, header.elements[i], out_v, out_t))
+                return false;
+        return true;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    bool is_swapped = header.format == PLY_BINARY_LITTLE_ENDIAN;
+#else
+    bool is_swapped = header.format == PLY_BINARY_BIG_ENDIAN;
+#endif
+    for (size_t i = 0; i < header.elements.size(); i++)
+    {
+        const PlyElement &element = header.elements[i];
+        bool is_read;
+        if (element.name == "vertex")
+            is_read = read_ply_binary_vertices(data, end, element, is_swapped, out_v);
+        else if (element.name == "face")
+            is_read = read_ply_binary_faces(data, end, element, is_swapped, out_t);
+        else
+            is_read = skip_ply_binary_element(data, end, element, is_swapped);
+        if (!is_read)
+        {
+            std::cout << "Invalid PLY element " << element.name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
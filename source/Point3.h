@@ -15,12 +15,13 @@ Comment:  This file contains all point definitions.
 ***************************************************************************/
 
 //-----------------------------------------------------------------------------
-/// Class for vectors or points with 3 double coordinates.
+/// Class for vectors or points with 3 coordinates of type Scalar.
 /**
 * This is the main class for all 3d points.
-* The type of the three coordinates is variable.
+* The type of the three coordinates is variable: Point3d has double coordinates.
 */
-class Point3d {
+template <typename Scalar>
+class Point3 {
 
 //-----------------------------------------------------------------------------
 public:
@@ -28,14 +29,14 @@ public:
   /**
   * Standard constructor. Point will be set to 0.0.
   */
-    Point3d()
+    Point3()
         : _x( 0.0 ), _y( 0.0 ), _z( 0.0 ) {}
 
   /**
   * Constructor with given value that will be set to all coordinates.
   * @param v - the value
   */
-    Point3d( double v )
+    Point3( Scalar v )
         : _x( v ), _y( v ), _z( v ) {}
 
   /**
@@ -44,44 +45,52 @@ public:
   * @param y - second coordinate of this point
   * @param z - third coordinate of this point
   */
-    Point3d( double x, double y, double z )
+    Point3( Scalar x, Scalar y, Scalar z )
         : _x( x ), _y( y ), _z( z ) {}
 
+  /**
+  * Constructor from a point with coordinates of another type (rounded if Scalar is smaller).
+  * @param p - the point
+  */
+    template <typename Other>
+    explicit Point3( const Point3<Other>& p )
+        : _x( p.x() ), _y( p.y() ), _z( p.z() ) {}
+
   /**
   * Returns the first coordinate of this point.
   * @return the \b first coordinate
   */
-    double& x() { return _x; }
+    Scalar& x() { return _x; }
 
   /**
   * Returns the first coordinate of this point (constant).
   * @return the \b first coordinate
   */
-   double x() const { return _x; }
+   Scalar x() const { return _x; }
 
   /**
   * Returns the second coordinate of this point.
   * @return the \b second coordinate
   */
-    double& y() { return _y; }
+    Scalar& y() { return _y; }
 
   /**
   * Returns the second coordinate of this point (constant).
   * @return the \b second coordinate
   */
-    double y() const { return _y; }
+    Scalar y() const { return _y; }
 
   /**
   * Returns the third coordinate of this point.
   * @return the \b third coordinate
   */
-    double& z() { return _z; }
+    Scalar& z() { return _z; }
 
   /**
   * Returns the third coordinate of this point (constant).
   * @return the \b third coordinate
   */
-    double z() const { return _z; }
+    Scalar z() const { return _z; }
 
   /**
   * Set the coords of this point.
@@ -89,7 +98,7 @@ public:
   * @param y - second coordinate of this point
   * @param z - third coordinate of this point
   */
-    void setCoords( const double x, const double y, const double z ) {
+    void setCoords( const Scalar x, const Scalar y, const Scalar z ) {
         _x = x; _y = y; _z = z;
     }
 
@@ -98,7 +107,7 @@ public:
   * @param i - index of the coordinate
   * @return the \b coordinate at index \em i
   */
-    double& operator [] ( const int i ) {
+    Scalar& operator [] ( const int i ) {
         assert( i < 3 );
         if ( i == 0 )
             return _x;
@@ -113,7 +122,7 @@ public:
   * @param i - index of the coordinate
   * @return the \b coordinate at index \em i
   */
-    double operator [] ( const int i ) const {
+    Scalar operator [] ( const int i ) const {
         assert( i < 3 );
         if ( i == 0 )
             return _x;
@@ -128,7 +137,7 @@ public:
   * @param p - point to compare with
   * @return \b true if this point is equal to p, else \b false
   */
-    bool operator == ( const Point3d& p ) const {
+    bool operator == ( const Point3& p ) const {
         if ( _x == p.x() && _y == p.y() && _z == p.z() )
             return true;
         return false;
@@ -138,8 +147,8 @@ public:
   * Operator that returns the inverted point.
   * @return the <b> inverted point </b>
   */
-    const Point3d operator - () const {
-        return Point3d( -_x, -_y, -_z );
+    const Point3 operator - () const {
+        return Point3( -_x, -_y, -_z );
     }
 
   /**
@@ -147,15 +156,15 @@ public:
   * @param p - the addend
   * @return the \b sum of the points
   */
-    const Point3d operator + ( const Point3d& p ) const {
-        return Point3d( _x + p.x(), _y + p.y(), _z + p.z() );
+    const Point3 operator + ( const Point3& p ) const {
+        return Point3( _x + p.x(), _y + p.y(), _z + p.z() );
     }
 
   /**
   * Add a point to this point.
   * @param p - the addend
   */
-    void operator += ( const Point3d& p ) {
+    void operator += ( const Point3& p ) {
         _x += p.x(); _y += p.y(); _z += p.z();
     }
 
@@ -164,15 +173,15 @@ public:
   * @param p - the subtrahend
   * @return the \b difference point
   */
-    const Point3d operator - ( const Point3d& p ) const {
-        return Point3d( _x - p.x(), _y - p.y(), _z - p.z() );
+    const Point3 operator - ( const Point3& p ) const {
+        return Point3( _x - p.x(), _y - p.y(), _z - p.z() );
     }
 
   /**
   * Substract a point from this point.
   * @param p - the subtrahend
   */
-    void operator -= ( const Point3d& p ) {
+    void operator -= ( const Point3& p ) {
         _x -= p.x(); _y -= p.y(); _z -= p.z();
     }
 
@@ -182,18 +191,18 @@ public:
   * @param w - the divisor
   * @return the <b> new point </b>
   */
-    const Point3d operator / ( const double w ) const {
-        return Point3d( _x / w, _y / w, _z / w );
+    const Point3 operator / ( const Scalar w ) const {
+        return Point3( _x / w, _y / w, _z / w );
     }
 
     /**
-     * Division operator for a Point3d p.
+     * Division operator for a Point3 p.
      * All coordinates will be divided by the coords of p.
      * @param p - the divisor
      * @return the <b> new point </b>
      */
-    const Point3d operator / ( const Point3d& p ) const {
-        return Point3d( _x / p.x(), _y / p.y(), _z / p.z() );
+    const Point3 operator / ( const Point3& p ) const {
+        return Point3( _x / p.x(), _y / p.y(), _z / p.z() );
     }
 
 
@@ -203,7 +212,7 @@ public:
   * @param w - the divisor
   * @return the <b> new point </b>
   */
-    friend const Point3d operator / ( const double w, const Point3d& p ) {
+    friend const Point3 operator / ( const Scalar w, const Point3& p ) {
         return p / w;
     }
 
@@ -211,7 +220,7 @@ public:
   * Divide all coordinates of this point by the given value.
   * @param w - the divisor
   */
-    void operator /= ( const double w ) {
+    void operator /= ( const Scalar w ) {
         _x /= w; _y /= w; _z /= w;
     }
 
@@ -221,18 +230,18 @@ public:
   * @param w - the multiplier
   * @return the <b> new point </b>
   */
-    const Point3d operator * ( const double w ) const {
-        return Point3d( _x * w, _y * w, _z * w );
+    const Point3 operator * ( const Scalar w ) const {
+        return Point3( _x * w, _y * w, _z * w );
     }
 
 
     /**
      * Return a new object composed by the max of coords of two objects.
      * @param p
-     * @return Point3d
+     * @return Point3
      */
-    const Point3d max_coords( const Point3d& p ) const {
-        Point3d res;
+    const Point3 max_coords( const Point3& p ) const {
+        Point3 res;
         if(_x > p.x())
             res.x() = _x;
         else
@@ -254,10 +263,10 @@ public:
     /**
      * Return a new object composed by the min of coords of two objects.
      * @param p
-     * @return Point3d
+     * @return Point3
      */
-    const Point3d min_coords( const Point3d& p ) const {
-        Point3d res;
+    const Point3 min_coords( const Point3& p ) const {
+        Point3 res;
         if(_x < p.x())
             res.x() = _x;
         else
@@ -283,7 +292,7 @@ public:
   * @param w - the multiplier
   * @return the <b> new point </b>
   */
-    friend const Point3d operator * ( const double w, const Point3d& p ) {
+    friend const Point3 operator * ( const Scalar w, const Point3& p ) {
         return p * w;
     }
 
@@ -291,7 +300,7 @@ public:
   * Multiply all coordinates of this point with the given value.
   * @param w - the multiplier
   */
-    void operator *= ( const double w ) {
+    void operator *= ( const Scalar w ) {
         _x *= w; _y *= w; _z *= w;
     }
 
@@ -300,8 +309,8 @@ public:
   * @param p - another point
   * @return the <b> cross product </b> of the two points
   */
-    const Point3d operator ^ ( const Point3d& p ) const {
-        return Point3d( ( _y * p.z() ) - ( p.y() * _z ),
+    const Point3 operator ^ ( const Point3& p ) const {
+        return Point3( ( _y * p.z() ) - ( p.y() * _z ),
                         ( _z * p.x() ) - ( p.z() * _x ), ( _x * p.y() ) - ( p.x() * _y ) );
     }
 
@@ -310,7 +319,7 @@ public:
   * @param p - another point
   * @return the <b> dot product </b> of the two points
   */
-    double operator * ( const Point3d& p ) const {
+    Scalar operator * ( const Point3& p ) const {
         return ( _x * p.x() + _y * p.y() + _z * p.z() );
     }
 
@@ -318,7 +327,7 @@ public:
   * Returns the norm of this vector.
   * @return the \b norm
   */
-    double norm() const {
+    Scalar norm() const {
         return sqrt( _x * _x + _y * _y + _z * _z );
     }
 
@@ -326,7 +335,7 @@ public:
   * returns the squared norm of this vector
   * @return the <b> squared norm </b>
   */
-    double squaredNorm() const {
+    Scalar squaredNorm() const {
         return _x * _x + _y * _y + _z * _z;
     }
 
@@ -334,13 +343,13 @@ public:
   * Normalize this point and return a new point with the calculated coordinates.
   * @return the <b> normalized point </b>
   */
-    const Point3d normalized() const {
+    const Point3 normalized() const {
         return ( *this / norm() );
     }
 
   /** Normalize this point. */
     void normalize() {
-        const double n = norm();
+        const Scalar n = norm();
         _x /= n; _y /= n; _z /= n;
     }
 
@@ -349,7 +358,7 @@ public:
   * @param p - another vector
   * @return the \b angle between the vectors
   */
-    double getAngle( const Point3d& p ) const {
+    Scalar getAngle( const Point3& p ) const {
         return ( atan2( ( *this ^ p ).norm(), ( *this * p ) ) );
     }
 
@@ -358,8 +367,8 @@ public:
   * @param p - another vector
   * @return the \b angle between the vectors
   */
-    double getAngle2( const Point3d& p ) const {
-        double dot = *this * p;
+    Scalar getAngle2( const Point3& p ) const {
+        Scalar dot = *this * p;
 
         // Force the dot product of the two input vectors to
         // fall within the domain for inverse cosine, which
@@ -367,7 +376,7 @@ public:
         // "domain error" math exceptions.
         dot = ( dot < -1.0 ? -1.0 : ( dot > 1.0 ? 1.0 : dot ) );
 
-        double angle = acos(dot);
+        Scalar angle = acos(dot);
 
         return (M_PI * 2) - angle;
     }
@@ -379,7 +388,7 @@ public:
   * @param s - the stream
   * @param p - the point
   */
-    friend std::ostream& operator << ( std::ostream& s, const Point3d& p )  {
+    friend std::ostream& operator << ( std::ostream& s, const Point3& p )  {
         s  << p.x() << "," << p.y()<< "," <<p.z() << std::endl;
         return s;
     }
@@ -388,12 +397,16 @@ public:
 private:
 
     /** The first coordinate. */
-    double _x;
+    Scalar _x;
     /** The second coordinate. */
-    double _y;
+    Scalar _y;
     /** The third coordinate. */
-    double _z;
+    Scalar _z;
 
 };
 
+//-----------------------------------------------------------------------------
+/// Point with 3 double coordinates.
+typedef Point3<double> Point3d;
+
 #endif
@@ -0,0 +1,117 @@
+#ifndef PRINCIPALCURVATURES_H
+#define PRINCIPALCURVATURES_H
+
+#include "Point3.h"
+#include <vector>
+#include <math.h>
+
+/***************************************************************************
+PrincipalCurvatures.h
+Comment:  This file contains the principal curvatures and principal directions of the vertices (shape operator).
+***************************************************************************/
+
+/**
+ * Meyer, Desbrun, Schroder, Barr, "Discrete Differential-Geometry Operators for Triangulated 2-Manifolds", section 5:
+ * the principal curvatures of a vertex are k1, k2 = H +- sqrt(max(H^2 - K, 0)) (H mean and K Gaussian curvature of the
+ * vertex), and the principal directions are the eigenvectors of the shape operator B (symmetric 2 x 2 in the tangent
+ * plane) fitted by weighted least squares to the normal curvatures of the edges of the one-ring: for the edge from x_i
+ * to x_j, with d its unit projection in the tangent plane, d^T B d = k_N = 2 (x_i - x_j) * N / |x_i - x_j|^2.
+ * The trace of B is fixed to 2H, so only 2 of its 3 coefficients are unknown.
+ * The curvatures are in the rescaled coords (as the Gaussian curvature, see BasicMeshCurvature).
+ */
+
+/**
+ * Outputs of the principal curvatures (see BasicMeshCurvature::load), k1 >= k2: per corner (as the other outputs of load,
+ * the values of the vertex of the corner) and per vertex.
+ */
+struct PrincipalCurvatureOutputs
+{
+    std::vector<float> curvatures;        // 2 floats per corner (6 per triangle): k1, k2
+    std::vector<float> directions_1;      // 3 floats per corner (9 per triangle): unit direction of k1
+    std::vector<float> directions_2;      // 3 floats per corner: unit direction of k2 (normal ^ direction of k1)
+    std::vector<float> curvatures_vertex; // 2 floats per vertex: k1, k2
+    std::vector<float> directions_vertex; // 6 floats per vertex: direction of k1, direction of k2
+};
+
+/**
+ * Least squares fit of the shape operator B = [a b; b 2H - a] of a vertex, in the tangent basis (u, v) of its normal:
+ * each edge adds w (a p + b q - r)^2 with p = du^2 - dv^2, q = 2 du dv and r = k_N - 2H dv^2.
+ */
+template <typename Accumulator>
+struct ShapeOperatorFit
+{
+    Point3<Accumulator> normal, u, v;
+    Accumulator mean_curvature;
+    Accumulator pp = 0, pq = 0, qq = 0, pr = 0, qr = 0; // sums of the normal equations
+
+    /**
+     * Tangent basis of a unit normal: u is orthogonal to the normal and to the axis of its smallest coord.
+     */
+    ShapeOperatorFit(const Point3<Accumulator> &normal, Accumulator mean_curvature) : normal(normal), mean_curvature(mean_curvature)
+    {
+        Point3<Accumulator> axis(0.0f, 0.0f, 0.0f);
+        Accumulator x = fabs(normal.x()), y = fabs(normal.y()), z = fabs(normal.z());
+        if (x <= y && x <= z)
+            axis.setCoords(1.0f, 0.0f, 0.0f);
+        else if (y <= z)
+            axis.setCoords(0.0f, 1.0f, 0.0f);
+        else
+            axis.setCoords(0.0f, 0.0f, 1.0f);
+        u = normal ^ axis;
+        u.normalize();
+        v = normal ^ u;
+    }
+
+    /**
+     * Add the edge x_j - x_i of the vertex x_i with a weight (edges orthogonal to the tangent plane are skipped).
+     */
+    void add_edge(const Point3<Accumulator> &edge, Accumulator weight)
+    {
+        Accumulator du = edge * u, dv = edge * v;
+        Accumulator squared_length = edge * edge, squared_tangent = du * du + dv * dv;
+        if (squared_length <= 0 || squared_tangent <= 0)
+            return;
+
+        Accumulator normal_curvature = -2 * (edge * normal) / squared_length;
+        Accumulator inverse_tangent = 1 / squared_tangent;
+        Accumulator cu = du * du * inverse_tangent, cv = dv * dv * inverse_tangent;
+        Accumulator p = cu - cv, q = 2 * du * dv * inverse_tangent, r = normal_curvature - 2 * mean_curvature * cv;
+        pp += weight * p * p;
+        pq += weight * p * q;
+        qq += weight * q * q;
+        pr += weight * p * r;
+        qr += weight * q * r;
+    }
+
+    /**
+     * Principal curvatures from the mean and the Gaussian curvature, principal directions from the fitted B (the
+     * eigenvector of its biggest eigenvalue goes with k1). A vertex with too few edges to fit B is taken as umbilic.
+     */
+    void solve(Accumulator gaussian_curvature, float curvatures[2], float directions[6]) const
+    {
+        Accumulator a = mean_curvature, b = 0;
+        Accumulator determinant = pp * qq - pq * pq;
+        if (determinant > 1e-12 * (pp + qq) * (pp + qq))
+        {
+            a = (qq * pr - pq * qr) / determinant;
+            b = (pp * qr - pq * pr) / determinant;
+        }
+        Accumulator c = 2 * mean_curvature - a;
+
+        Accumulator angle = atan2(2 * b, a - c) / 2;
+        Point3<Accumulator> direction_1 = u * (Accumulator)cos(angle) + v * (Accumulator)sin(angle);
+        Point3<Accumulator> direction_2 = normal ^ direction_1;
+
+        Accumulator discriminant = mean_curvature * mean_curvature - gaussian_curvature;
+        Accumulator root = discriminant > 0 ? sqrt(discriminant) : 0;
+        curvatures[0] = mean_curvature + root;
+        curvatures[1] = mean_curvature - root;
+        for (int i = 0; i < 3; i++)
+        {
+            directions[i] = direction_1[i];
+            directions[3 + i] = direction_2[i];
+        }
+    }
+};
+
+#endif
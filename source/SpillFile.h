@@ -0,0 +1,115 @@
+#ifndef SPILLFILE_H
+#define SPILLFILE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/***************************************************************************
+SpillFile.h
+Comment:  This file contains a temporary file mapped in memory for data bigger than the RAM.
+***************************************************************************/
+
+/**
+ * Zero-initialized array of bytes backed by a temporary file.
+ * On POSIX systems the file is mapped with mmap (shared), so the kernel writes the pages back to disk
+ * and evicts them when memory is needed: only the pages in use stay in RAM. The file is removed as soon
+ * as it is mapped, nothing is left on disk when the program ends. On other systems the bytes are in a buffer.
+ */
+class SpillFile
+{
+  public:
+    SpillFile() : bytes(NULL), length(0) {}
+
+    ~SpillFile()
+    {
+        close();
+    }
+
+    /**
+     * Create the temporary file at path with the given size and map it. Return false if it cannot be created.
+     */
+    bool open(const char *path, size_t size)
+    {
+        close();
+#if defined(_WIN32)
+        buffer.assign(size, 0);
+        bytes = buffer.data();
+        length = size;
+        return true;
+#else
+        int descriptor = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (descriptor < 0)
+            return false;
+        unlink(path); // the file lives until it is unmapped
+
+        if (size == 0) // mmap does not accept empty files
+        {
+            ::close(descriptor);
+            return true;
+        }
+
+        void *address = MAP_FAILED;
+        if (ftruncate(descriptor, size) == 0)
+            address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        ::close(descriptor);
+        if (address == MAP_FAILED)
+            return false;
+
+        bytes = (char *)address;
+        length = size;
+        return true;
+#endif
+    }
+
+    /**
+     * Unmap and remove the file (it is called automatically by the destructor).
+     */
+    void close()
+    {
+#if defined(_WIN32)
+        buffer.clear();
+        buffer.shrink_to_fit();
+#else
+        if (bytes)
+            munmap(bytes, length);
+#endif
+        bytes = NULL;
+        length = 0;
+    }
+
+    /**
+     * The bytes of the file as an array of T.
+     */
+    template <typename T>
+    T *data() const
+    {
+        return (T *)bytes;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+  private:
+    // a mapping cannot be shared between two objects
+    SpillFile(const SpillFile &);
+    SpillFile &operator=(const SpillFile &);
+
+    char *bytes;
+    size_t length;
+#if defined(_WIN32)
+    std::vector<char> buffer;
+#endif
+};
+
+#endif
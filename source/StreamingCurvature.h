@@ -0,0 +1,281 @@
+#ifndef STREAMINGCURVATURE_H
+#define STREAMINGCURVATURE_H
+
+#include "LoaderObject.h"
+#include "SpillFile.h"
+#include <algorithm>
+#include <string>
+#include <stdint.h>
+#include <limits.h>
+
+/***************************************************************************
+StreamingCurvature.h
+Comment:  This file computes Gaussian and mean curvature per vertex of meshes bigger than the RAM.
+***************************************************************************/
+
+/**
+ * Streaming mode of load(): the mesh is never stored in vectors and there are no edges.
+ * - the OFF file is parsed into spill files (vertices and triangles, see SpillFile.h): a first pass over the faces
+ *   counts the triangles of the polygons (fans, as parse_off_face), the second one writes the faces first and the
+ *   other triangles of the polygons after them, in the order of load(). The vertices are then rescaled into spill
+ *   files of Position as VertexPositions,
+ * - the triangle pass computes the geometry of blocks of triangles (compute_triangle_geometry with the AVX2 kernel if
+ *   use_simd_kernel, as the first pass of compute_curvatures: both split the triangles in groups of 4) and adds the
+ *   values of their corners (angle, Area mixed, cotangent Laplacian, normal) to the sums of their vertices, spilled in
+ *   Accumulator. The corners of a block are sorted by vertex (and by triangle for the same vertex) before they are
+ *   added, so each vertex receives the values of its corners in the same order as compute_vertex_values and the
+ *   results are the same as load() with the same precisions and kernel,
+ * - the vertex pass writes the curvatures from the sums.
+ * There is no edge pairing (and no external sort of the edges): the mean curvature is the norm of the sum of the
+ * cotangent Laplacians of the corners, each corner gives the terms of its two edges, so a triangle needs only its
+ * own vertices.
+ * memory_budget bounds the buffers of a block of triangles; the spill files are mapped, the kernel keeps in RAM only
+ * the pages in use and writes them back when memory is needed. The sums are updated in vertex order in each block,
+ * so a block reads and writes each page of the sums at most once, but the positions of its triangles are gathered in
+ * the order of the triangles: for meshes whose vertices are not in spatial order (see MeshReorder.h) the I/O of a
+ * block can reach the size of the positions and of the sums, and the pages in RAM are bounded only by the kernel.
+ * The numbers of vertices, faces and triangles are int64_t; the indices of the vertices are int (as Triangle and the
+ * kernel), so at most INT_MAX vertices.
+ */
+
+// memory (bytes) for the buffers of the streaming mode
+size_t streaming_memory_budget = 256 << 20;
+
+/**
+ * Sums of the values of the corners of a vertex (in the order of the triangles).
+ */
+template <typename Accumulator>
+struct StreamingVertexSums
+{
+    Point3<Accumulator> normal;    // normals of the triangles
+    Point3<Accumulator> laplacian; // cotangent Laplacian of the corners, in the rescaled coords
+    Accumulator angle_defeact_sum; // angles of the corners
+    Accumulator area_mixed;        // parts of the Area mixed
+    int triangles_count;
+};
+
+/**
+ * Compute Gaussian and mean curvature per vertex of the OFF file at path with bounded memory, in the precisions of
+ * the engine MeshCurvature (Scalar for the geometry of the triangles, Accumulator for the sums per vertex, Position for
+ * the positions).
+ * output_path is written with num_vertices floats of Gaussian curvature followed by num_vertices floats
+ * of mean curvature (the values of gc_vertex_size and mc_vertex_size_vertex of load()).
+ * Temporary files are created next to output_path.
+ */
+template <typename Scalar = MeshCurvature::scalar_type, typename Accumulator = MeshCurvature::accumulator_type, typename Position = MeshCurvature::position_type>
+bool load_streaming(const char *path, const char *output_path, size_t memory_budget = streaming_memory_budget)
+{
+    // --------------------- Read file -----------------------------
+    MappedFile file;
+    if (!file.open(path))
+    {
+        cout << "\nError reading file." << endl;
+        return false;
+    }
+
+    MeshTokenizer tokenizer(file.begin(), file.end());
+    int64_t vertices_count, faces_count;
+    if (!parse_off_header(tokenizer, vertices_count, faces_count))
+        return false;
+    if (faces_count == 0)
+    {
+        cout << "The mesh has no faces." << endl;
+        return false;
+    }
+    if (vertices_count > INT_MAX)
+    {
+        cout << "The mesh has more than " << INT_MAX << " vertices." << endl;
+        return false;
+    }
+
+    std::string temporary_path = get_temporary_path(output_path);
+    SpillFile vertices_file;
+    if (!vertices_file.open((temporary_path + ".v").c_str(), (size_t)vertices_count * sizeof(Point3d)))
+    {
+        cout << "Error creating temporary files for " << output_path << endl;
+        return false;
+    }
+    Point3d *vertices = vertices_file.data<Point3d>();
+
+    for (int64_t i = 0; i < vertices_count; i++)
+    {
+        if (!parse_off_vertex(tokenizer, vertices[i]))
+        {
+            cout << "Invalid vertex " << i << " in OFF file." << endl;
+            return false;
+        }
+    }
+
+    // first pass over the faces: number of triangles of the polygons
+    const char *faces_begin = tokenizer.position();
+    int64_t triangles_count = 0;
+    for (int64_t i = 0; i < faces_count; i++)
+    {
+        int size;
+        if (!tokenizer.next_int(size) || size < 3)
+        {
+            cout << "Invalid face " << i << " in OFF file." << endl;
+            return false;
+        }
+        triangles_count += size - 2;
+        tokenizer.skip_line();
+    }
+
+    // second pass: the faces, then the other triangles of the polygons (as parse_off_buffer)
+    SpillFile faces_file;
+    if (!faces_file.open((temporary_path + ".t").c_str(), (size_t)triangles_count * 3 * sizeof(int32_t)))
+    {
+        cout << "Error creating temporary files for " << output_path << endl;
+        return false;
+    }
+    int32_t *faces = faces_file.data<int32_t>();
+
+    tokenizer = MeshTokenizer(faces_begin, file.end());
+    int64_t polygon_triangle = faces_count;
+    for (int64_t i = 0; i < faces_count; i++)
+    {
+        int size, index, previous = 0;
+        bool is_valid = tokenizer.next_int(size);
+        for (int j = 0; j < size && is_valid; j++)
+        {
+            is_valid = tokenizer.next_int(index) && index >= 0 && index < vertices_count;
+            if (is_valid && j < 3)
+                faces[i * 3 + j] = index;
+            else if (is_valid) // fan [v0, v(j-1), vj]
+            {
+                int32_t *fan = faces + polygon_triangle++ * 3;
+                fan[0] = faces[i * 3];
+                fan[1] = previous;
+                fan[2] = index;
+            }
+            previous = index;
+        }
+        if (!is_valid)
+        {
+            cout << "Invalid index in face " << i << " of OFF file." << endl;
+            return false;
+        }
+        tokenizer.skip_line();
+    }
+    file.close();
+
+    // find min value and max value of a mesh (as MeshCurvature::set_max_min_mesh)
+    double min_coord = fmin(fmin(vertices[faces[0]].x(), vertices[faces[0]].y()), vertices[faces[0]].z());
+    double max_coord = fmax(fmax(vertices[faces[0]].x(), vertices[faces[0]].y()), vertices[faces[0]].z());
+    for (int64_t k = 0; k < triangles_count * 3; k++)
+        set_min_max(vertices[faces[k]], min_coord, max_coord);
+    double file_scale = (max_coord - min_coord) / interval;
+
+    // ------- POSITIONS (spilled): rescaled as build_vertex_positions -------
+    SpillFile positions_file;
+    if (!positions_file.open((temporary_path + ".p").c_str(), (size_t)vertices_count * 3 * sizeof(Position)))
+    {
+        cout << "Error creating temporary files for " << output_path << endl;
+        return false;
+    }
+    Position *x = positions_file.data<Position>();
+    Position *y = x + vertices_count;
+    Position *z = y + vertices_count;
+    double scale = interval / (max_coord - min_coord);
+    for (int64_t i = 0; i < vertices_count; i++)
+    {
+        x[i] = scale * (vertices[i].x() - max_coord) + 1;
+        y[i] = scale * (vertices[i].y() - max_coord) + 1;
+        z[i] = scale * (vertices[i].z() - max_coord) + 1;
+    }
+    vertices_file.close();
+
+    // ------- ACCUMULATORS (spilled) -------
+    SpillFile sums_file;
+    if (!sums_file.open((temporary_path + ".s").c_str(), (size_t)vertices_count * sizeof(StreamingVertexSums<Accumulator>)))
+    {
+        cout << "Error creating temporary files for " << output_path << endl;
+        return false;
+    }
+    StreamingVertexSums<Accumulator> *sums = sums_file.data<StreamingVertexSums<Accumulator> >();
+
+    // ------- TRIANGLE PASS: geometry of a block of triangles, then the sums of the vertices of its corners -------
+    // angles, areas, Laplacians, area of the triangle and the sorted corners
+    size_t triangle_bytes = sizeof(Triangle) + 16 * sizeof(Scalar) + 3 * sizeof(uint64_t);
+    int block_size = (int)min((int64_t)(max((size_t)64, memory_budget / triangle_bytes) / 4 * 4), triangles_count); // groups of 4 as compute_curvatures
+    vector<Triangle> block(block_size);
+    vector<Scalar> corner_angle((size_t)block_size * 3), corner_area_mixed((size_t)block_size * 3), corner_laplacian((size_t)block_size * 9), triangle_area(block_size);
+    vector<uint64_t> sorted_corners((size_t)block_size * 3); // vertex << 32 | corner
+    TriangleGeometry<Scalar> geometry = {corner_angle.data(), corner_area_mixed.data(), NULL, triangle_area.data(), corner_laplacian.data()};
+    for (int64_t first = 0; first < triangles_count; first += block_size)
+    {
+        int count = (int)min((int64_t)block_size, triangles_count - first);
+        for (int k = 0; k < count; k++)
+            for (int j = 0; j < 3; j++)
+                block[k].v[j] = faces[(first + k) * 3 + j];
+        compute_triangle_geometry(block.data(), x, y, z, 0, count, geometry, use_simd_kernel);
+
+        for (int corner = 0; corner < count * 3; corner++)
+            sorted_corners[corner] = (uint64_t)block[corner / 3].v[corner % 3] << 32 | (uint32_t)corner;
+        sort(sorted_corners.begin(), sorted_corners.begin() + count * 3);
+
+        for (int i = 0; i < count * 3; i++)
+        {
+            StreamingVertexSums<Accumulator> &vertex_sums = sums[sorted_corners[i] >> 32];
+            size_t corner = (uint32_t)sorted_corners[i];
+            vertex_sums.normal += Point3<Accumulator>(block[corner / 3].n);
+            vertex_sums.angle_defeact_sum += corner_angle[corner];
+            vertex_sums.area_mixed += corner_area_mixed[corner];
+            vertex_sums.laplacian += Point3<Accumulator>(corner_laplacian[corner * 3], corner_laplacian[corner * 3 + 1], corner_laplacian[corner * 3 + 2]);
+            vertex_sums.triangles_count++;
+        }
+    }
+    faces_file.close();
+    positions_file.close();
+
+    // ------- VERTEX PASS: Gaussian curvature then mean curvature (as compute_vertex_values) -------
+    FILE *output = fopen(output_path, "wb");
+    if (!output)
+    {
+        cout << "Error writing " << output_path << endl;
+        return false;
+    }
+    vector<float> values;
+    values.reserve(1 << 16);
+    bool is_written = true;
+    for (int pass = 0; pass < 2 && is_written; pass++)
+    {
+        for (int64_t k = 0; k < vertices_count && is_written; k++)
+        {
+            const StreamingVertexSums<Accumulator> &vertex_sums = sums[k];
+            if (pass == 0)
+                values.push_back(((2 * M_PI) - vertex_sums.angle_defeact_sum) / vertex_sums.area_mixed);
+            else
+            {
+                Point3<Accumulator> normal = vertex_sums.normal;
+                if (vertex_sums.triangles_count != 0)
+                    normal = normal / vertex_sums.triangles_count;
+                normal.normalize();
+
+                Point3<Accumulator> mc_vertex_sum = vertex_sums.laplacian * (Accumulator)file_scale; // edge vectors in the coords of the file
+                float current_mean_curvature_value = (((1.0f / (2 * vertex_sums.area_mixed)) * mc_vertex_sum).norm()) / 2.0f;
+                if (mc_vertex_sum * normal < 0)
+                    current_mean_curvature_value = (-1) * current_mean_curvature_value;
+                values.push_back(current_mean_curvature_value);
+            }
+
+            if (values.size() == values.capacity() || k == vertices_count - 1)
+            {
+                is_written = fwrite(&values[0], sizeof(float), values.size(), output) == values.size();
+                values.clear();
+            }
+        }
+    }
+    is_written = (fclose(output) == 0) && is_written;
+    if (!is_written)
+    {
+        cout << "Error writing " << output_path << endl;
+        remove(output_path);
+        return false;
+    }
+
+    cout << "Object streamed (" << (triangles_count + block_size - 1) / block_size << " blocks of triangles)" << endl;
+    return true;
+}
+
+#endif
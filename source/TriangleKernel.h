@@ -0,0 +1,320 @@
+#ifndef TRIANGLEKERNEL_H
+#define TRIANGLEKERNEL_H
+
+#include "Point3.h"
+#include "CurvatureEstimators.h"
+#include <math.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TRIANGLE_KERNEL_AVX2
+#include <immintrin.h>
+#endif
+
+/***************************************************************************
+TriangleKernel.h
+Comment:  This file computes the geometry of 4 triangles at a time with AVX2.
+***************************************************************************/
+
+/**
+ * The kernel reads the rescaled positions as structure of arrays of floats or doubles (x[], y[], z[], see
+ * VertexPositions.h), gathers the 3 vertices of 4 triangles into 4-wide registers of doubles and computes in one pass the face normals,
+ * the angles, the cotangents, the areas, the parts of the area of the vertices of the corners (one overload of
+ * get_corner_areas_avx2 for each area estimator of CurvatureEstimators.h) and the cotangent Laplacian of the corners, with the same operations in
+ * the same order as get_triangle_corners of LoaderObject.h in double. Only atan2 (angles) differs: it is a Cephes rational
+ * approximation instead of the libm one (about 1 ulp). So with doubles the normals, cotangents, areas and Area mixed
+ * are the same and the angles differ by a few ulps, about 1e-7 relative on the float curvatures (see ./benchmark kernel).
+ * Float positions are widened exactly, so with float positions and a geometry in double (the default engine, see
+ * BasicMeshCurvature) the kernel and get_triangle_corners compute the same values from the same inputs. With a
+ * geometry in float the kernel still computes in double and rounds its results to float, so it is more accurate than
+ * get_triangle_corners in float. The code
+ * is compiled for AVX2 with a target attribute and used only if the CPU has it (is_avx2_supported), so the program
+ * still runs on any x86 CPU.
+ */
+
+/**
+ * Outputs of the geometry of the triangles (arrays indexed by corner 3 * triangle + corner, or by triangle), in the
+ * precision of the engine. The face normals are written in the triangles. corner_cot and corner_laplacian are not
+ * written if they are NULL.
+ */
+template <typename Scalar>
+struct TriangleGeometry
+{
+    Scalar *corner_angle;      // angle of the triangle at the corner
+    Scalar *corner_area_mixed; // part of the area of the vertex of the corner (Area mixed with MixedVoronoiArea)
+    Scalar *corner_cot;        // cotangent of the angle at the corner
+    Scalar *triangle_area;     // area of the triangle
+    Scalar *corner_laplacian;  // x, y, z for each corner: cot(opposite angle) * (vertex - other vertex) summed over the 2 edges of the corner
+};
+
+/**
+ * True if the CPU can run compute_triangle_geometry_avx2.
+ */
+inline bool is_avx2_supported()
+{
+#ifdef TRIANGLE_KERNEL_AVX2
+    static const bool is_supported = __builtin_cpu_supports("avx2");
+    return is_supported;
+#else
+    return false;
+#endif
+}
+
+#ifdef TRIANGLE_KERNEL_AVX2
+
+// 4 vectors in 4-wide registers (one lane for each triangle)
+struct Vector3Avx2
+{
+    __m256d x, y, z;
+};
+
+__attribute__((target("avx2"))) inline Vector3Avx2 subtract_avx2(const Vector3Avx2 &a, const Vector3Avx2 &b)
+{
+    Vector3Avx2 result = {_mm256_sub_pd(a.x, b.x), _mm256_sub_pd(a.y, b.y), _mm256_sub_pd(a.z, b.z)};
+    return result;
+}
+
+/**
+ * Cross product, as Point3d::operator ^.
+ */
+__attribute__((target("avx2"))) inline Vector3Avx2 cross_avx2(const Vector3Avx2 &a, const Vector3Avx2 &b)
+{
+    Vector3Avx2 result = {_mm256_sub_pd(_mm256_mul_pd(a.y, b.z), _mm256_mul_pd(b.y, a.z)),
+                          _mm256_sub_pd(_mm256_mul_pd(a.z, b.x), _mm256_mul_pd(b.z, a.x)),
+                          _mm256_sub_pd(_mm256_mul_pd(a.x, b.y), _mm256_mul_pd(b.x, a.y))};
+    return result;
+}
+
+/**
+ * Dot product, as Point3d::operator *.
+ */
+__attribute__((target("avx2"))) inline __m256d dot_avx2(const Vector3Avx2 &a, const Vector3Avx2 &b)
+{
+    return _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a.x, b.x), _mm256_mul_pd(a.y, b.y)), _mm256_mul_pd(a.z, b.z));
+}
+
+__attribute__((target("avx2"))) inline __m256d norm_avx2(const Vector3Avx2 &a)
+{
+    return _mm256_sqrt_pd(dot_avx2(a, a));
+}
+
+__attribute__((target("avx2"))) inline void normalize_avx2(Vector3Avx2 &a)
+{
+    __m256d norm = norm_avx2(a);
+    a.x = _mm256_div_pd(a.x, norm);
+    a.y = _mm256_div_pd(a.y, norm);
+    a.z = _mm256_div_pd(a.z, norm);
+}
+
+/**
+ * atan(r) for 0 <= r <= 1 (Cephes atan: rational approximation, with atan(r) = pi/4 + atan((r - 1) / (r + 1)) above 0.66).
+ */
+__attribute__((target("avx2"))) inline __m256d atan_unit_avx2(__m256d r)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256d is_big = _mm256_cmp_pd(r, _mm256_set1_pd(0.66), _CMP_GT_OQ);
+    __m256d x = _mm256_blendv_pd(r, _mm256_div_pd(_mm256_sub_pd(r, one), _mm256_add_pd(r, one)), is_big);
+
+    __m256d z = _mm256_mul_pd(x, x);
+    __m256d p = _mm256_set1_pd(-8.750608600031904122785E-1);
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(-1.615753718733365076637E1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(-7.500855792314704667340E1));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(-1.228866684490136173410E2));
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(-6.485021904942025371773E1));
+    __m256d q = _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962E1));
+    q = _mm256_add_pd(_mm256_mul_pd(q, z), _mm256_set1_pd(1.650270098316988542046E2));
+    q = _mm256_add_pd(_mm256_mul_pd(q, z), _mm256_set1_pd(4.328810604912902668951E2));
+    q = _mm256_add_pd(_mm256_mul_pd(q, z), _mm256_set1_pd(4.853903996359136964868E2));
+    q = _mm256_add_pd(_mm256_mul_pd(q, z), _mm256_set1_pd(1.945506571482613964425E2));
+    z = _mm256_div_pd(_mm256_mul_pd(z, p), q);
+    z = _mm256_add_pd(_mm256_mul_pd(x, z), x);
+
+    z = _mm256_add_pd(z, _mm256_and_pd(is_big, _mm256_set1_pd(0.5 * 6.123233995736765886130E-17))); // low bits of pi/4
+    return _mm256_add_pd(_mm256_and_pd(is_big, _mm256_set1_pd(M_PI / 4)), z);
+}
+
+/**
+ * atan2(s, c) for s >= 0 (angle between 0 and pi, as Point3d::getAngle).
+ */
+__attribute__((target("avx2"))) inline __m256d atan2_positive_avx2(__m256d s, __m256d c)
+{
+    __m256d abs_c = _mm256_andnot_pd(_mm256_set1_pd(-0.0), c);
+    __m256d numerator = _mm256_min_pd(s, abs_c);
+    __m256d denominator = _mm256_max_pd(s, abs_c);
+    __m256d is_zero = _mm256_cmp_pd(denominator, _mm256_setzero_pd(), _CMP_EQ_OQ);
+    __m256d angle = atan_unit_avx2(_mm256_andnot_pd(is_zero, _mm256_div_pd(numerator, denominator)));
+
+    __m256d half_pi = _mm256_set1_pd(M_PI / 2);
+    angle = _mm256_blendv_pd(angle, _mm256_sub_pd(half_pi, angle), _mm256_cmp_pd(s, abs_c, _CMP_GT_OQ));
+    return _mm256_blendv_pd(angle, _mm256_sub_pd(_mm256_set1_pd(M_PI), angle), _mm256_cmp_pd(c, _mm256_setzero_pd(), _CMP_LT_OQ));
+}
+
+/**
+ * Voronoi region of the vertex of each corner (as get_corner_voronoi_area of CurvatureEstimators.h).
+ */
+__attribute__((target("avx2"))) inline void get_corner_voronoi_areas_avx2(const __m256d cot[3], const __m256d squared_length[3], __m256d voronoi[3])
+{
+    __m256d eight = _mm256_set1_pd(8);
+    voronoi[0] = _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(squared_length[1], cot[1]), _mm256_mul_pd(squared_length[2], cot[2])), eight);
+    voronoi[1] = _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(squared_length[0], cot[0]), _mm256_mul_pd(squared_length[2], cot[2])), eight);
+    voronoi[2] = _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(squared_length[0], cot[0]), _mm256_mul_pd(squared_length[1], cot[1])), eight);
+}
+
+/**
+ * Parts of the area of the vertices of the corners, one overload for each area estimator of CurvatureEstimators.h
+ * (same operations as its get_corner_areas).
+ */
+__attribute__((target("avx2"))) inline void get_corner_areas_avx2(MixedVoronoiArea, const __m256d dot[3], const __m256d cot[3], const __m256d squared_length[3], __m256d area, __m256d corner_area[3])
+{
+    __m256d voronoi[3];
+    get_corner_voronoi_areas_avx2(cot, squared_length, voronoi);
+    // not (all dots >= 0), as the test of MixedVoronoiArea (true for NaN)
+    __m256d is_obtuse_triangle = _mm256_or_pd(_mm256_or_pd(_mm256_cmp_pd(dot[0], _mm256_setzero_pd(), _CMP_NGE_UQ),
+                                                           _mm256_cmp_pd(dot[1], _mm256_setzero_pd(), _CMP_NGE_UQ)),
+                                              _mm256_cmp_pd(dot[2], _mm256_setzero_pd(), _CMP_NGE_UQ));
+    __m256d quarter = _mm256_div_pd(area, _mm256_set1_pd(4)), half = _mm256_div_pd(area, _mm256_set1_pd(2));
+    for (int c = 0; c < 3; c++)
+    {
+        __m256d is_obtuse_corner = _mm256_cmp_pd(dot[c], _mm256_setzero_pd(), _CMP_LT_OQ);
+        corner_area[c] = _mm256_blendv_pd(voronoi[c], _mm256_blendv_pd(quarter, half, is_obtuse_corner), is_obtuse_triangle);
+    }
+}
+
+__attribute__((target("avx2"))) inline void get_corner_areas_avx2(BarycentricArea, const __m256d dot[3], const __m256d cot[3], const __m256d squared_length[3], __m256d area, __m256d corner_area[3])
+{
+    __m256d third = _mm256_div_pd(area, _mm256_set1_pd(3));
+    for (int c = 0; c < 3; c++)
+        corner_area[c] = third;
+}
+
+__attribute__((target("avx2"))) inline void get_corner_areas_avx2(CircumcentricArea, const __m256d dot[3], const __m256d cot[3], const __m256d squared_length[3], __m256d area, __m256d corner_area[3])
+{
+    get_corner_voronoi_areas_avx2(cot, squared_length, corner_area);
+}
+
+/**
+ * Gather 4 values (at 4 indices) as doubles.
+ */
+__attribute__((target("avx2"))) inline __m256d gather_avx2(const float *values, __m128i index)
+{
+    return _mm256_cvtps_pd(_mm_mask_i32gather_ps(_mm_setzero_ps(), values, index, _mm_castsi128_ps(_mm_set1_epi32(-1)), 4));
+}
+
+__attribute__((target("avx2"))) inline __m256d gather_avx2(const double *values, __m128i index)
+{
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), values, index, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+}
+
+/**
+ * Geometry of the triangles begin, begin + 1 ... in groups of 4 (normals written in the triangles), from the rescaled
+ * positions x, y, z (float or double), with the area estimator AreaEstimator, written in Scalar (float or double).
+ * The angles are computed only if Estimators uses them, the parts of the area only if it uses the areas of the vertices.
+ * Return the first triangle not computed (less than 4 before end): the caller does the rest.
+ */
+template <typename AreaEstimator = MixedVoronoiArea, typename Estimators = AllCurvatureEstimators, typename TriangleType, typename Position, typename Scalar>
+__attribute__((target("avx2"))) int compute_triangle_geometry_avx2(TriangleType *triangles, const Position *x, const Position *y, const Position *z, int begin, int end, const TriangleGeometry<Scalar> &geometry)
+{
+    int k = begin;
+    for (; k + 4 <= end; k += 4)
+    {
+        // gather the 3 vertices of the 4 triangles
+        alignas(16) int indices[3][4];
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 3; j++)
+                indices[j][i] = triangles[k + i].v[j];
+        Vector3Avx2 v[3];
+        for (int j = 0; j < 3; j++)
+        {
+            __m128i index = _mm_load_si128((const __m128i *)indices[j]);
+            v[j].x = gather_avx2(x, index);
+            v[j].y = gather_avx2(y, index);
+            v[j].z = gather_avx2(z, index);
+        }
+
+        Vector3Avx2 v0v1 = subtract_avx2(v[1], v[0]);
+        Vector3Avx2 v0v2 = subtract_avx2(v[2], v[0]);
+        Vector3Avx2 v1v2 = subtract_avx2(v[2], v[1]);
+
+        // -- normals and areas ---
+        Vector3Avx2 n = cross_avx2(v0v1, v0v2);
+        __m256d cross_norm = norm_avx2(n);
+        normalize_avx2(n);
+        __m256d area = _mm256_div_pd(cross_norm, _mm256_set1_pd(2));
+
+        // -- angles and cotangents: angle = atan2(|a ^ b|, a * b), cot = (a * b) / |a ^ b| ---
+        __m256d dot[3] = {dot_avx2(v0v1, v0v2), _mm256_xor_pd(dot_avx2(v0v1, v1v2), _mm256_set1_pd(-0.0)), dot_avx2(v0v2, v1v2)};
+        __m256d angle[3], cot[3];
+        for (int c = 0; c < 3; c++)
+        {
+            if (Estimators::has_corner_angles)
+                angle[c] = atan2_positive_avx2(cross_norm, dot[c]);
+            cot[c] = _mm256_div_pd(dot[c], cross_norm);
+        }
+
+        // -- parts of the areas of the vertices ---
+        __m256d corner_area[3];
+        if (Estimators::has_vertex_areas)
+        {
+            __m256d squared_length[3] = {dot_avx2(v1v2, v1v2), dot_avx2(v0v2, v0v2), dot_avx2(v0v1, v0v1)};
+            get_corner_areas_avx2(AreaEstimator(), dot, cot, squared_length, area, corner_area);
+        }
+
+        // -- cotangent Laplacian of the corners: -(v0v1 cot2 + v0v2 cot1), v0v1 cot2 - v1v2 cot0, v0v2 cot1 + v1v2 cot0 ---
+        Vector3Avx2 laplacian[3];
+        if (geometry.corner_laplacian)
+        {
+            __m256d sign = _mm256_set1_pd(-0.0);
+            laplacian[0].x = _mm256_xor_pd(_mm256_add_pd(_mm256_mul_pd(v0v1.x, cot[2]), _mm256_mul_pd(v0v2.x, cot[1])), sign);
+            laplacian[0].y = _mm256_xor_pd(_mm256_add_pd(_mm256_mul_pd(v0v1.y, cot[2]), _mm256_mul_pd(v0v2.y, cot[1])), sign);
+            laplacian[0].z = _mm256_xor_pd(_mm256_add_pd(_mm256_mul_pd(v0v1.z, cot[2]), _mm256_mul_pd(v0v2.z, cot[1])), sign);
+            laplacian[1].x = _mm256_sub_pd(_mm256_mul_pd(v0v1.x, cot[2]), _mm256_mul_pd(v1v2.x, cot[0]));
+            laplacian[1].y = _mm256_sub_pd(_mm256_mul_pd(v0v1.y, cot[2]), _mm256_mul_pd(v1v2.y, cot[0]));
+            laplacian[1].z = _mm256_sub_pd(_mm256_mul_pd(v0v1.z, cot[2]), _mm256_mul_pd(v1v2.z, cot[0]));
+            laplacian[2].x = _mm256_add_pd(_mm256_mul_pd(v0v2.x, cot[1]), _mm256_mul_pd(v1v2.x, cot[0]));
+            laplacian[2].y = _mm256_add_pd(_mm256_mul_pd(v0v2.y, cot[1]), _mm256_mul_pd(v1v2.y, cot[0]));
+            laplacian[2].z = _mm256_add_pd(_mm256_mul_pd(v0v2.z, cot[1]), _mm256_mul_pd(v1v2.z, cot[0]));
+        }
+
+        // -- write the lanes ---
+        alignas(32) double lanes[22][4];
+        _mm256_store_pd(lanes[0], n.x);
+        _mm256_store_pd(lanes[1], n.y);
+        _mm256_store_pd(lanes[2], n.z);
+        _mm256_store_pd(lanes[3], area);
+        for (int c = 0; c < 3; c++)
+        {
+            if (Estimators::has_corner_angles)
+                _mm256_store_pd(lanes[4 + c], angle[c]);
+            _mm256_store_pd(lanes[7 + c], cot[c]);
+            if (Estimators::has_vertex_areas)
+                _mm256_store_pd(lanes[10 + c], corner_area[c]);
+            if (geometry.corner_laplacian)
+            {
+                _mm256_store_pd(lanes[13 + c * 3], laplacian[c].x);
+                _mm256_store_pd(lanes[14 + c * 3], laplacian[c].y);
+                _mm256_store_pd(lanes[15 + c * 3], laplacian[c].z);
+            }
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            int triangle = k + i;
+            triangles[triangle].n = Point3d(Point3<Scalar>(lanes[0][i], lanes[1][i], lanes[2][i]));
+            geometry.triangle_area[triangle] = lanes[3][i];
+            for (int c = 0; c < 3; c++)
+            {
+                if (Estimators::has_corner_angles)
+                    geometry.corner_angle[triangle * 3 + c] = lanes[4 + c][i];
+                if (geometry.corner_cot)
+                    geometry.corner_cot[triangle * 3 + c] = lanes[7 + c][i];
+                if (Estimators::has_vertex_areas)
+                    geometry.corner_area_mixed[triangle * 3 + c] = lanes[10 + c][i];
+            }
+            for (int j = 0; j < 9 && geometry.corner_laplacian; j++)
+                geometry.corner_laplacian[triangle * 9 + j] = lanes[13 + j][i];
+        }
+    }
+    return k;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef VERTEXADJACENCY_H
+#define VERTEXADJACENCY_H
+
+#include "MeshEdges.h"
+#include <vector>
+
+/***************************************************************************
+VertexAdjacency.h
+Comment:  This file contains the vertex -> triangles and vertex -> vertices adjacency of a mesh.
+***************************************************************************/
+
+/**
+ * Both adjacencies are in compressed sparse row form: the items of vertex i are items[begin[i]] ... items[begin[i + 1] - 1].
+ * The incident triangles of a vertex are stored as its corners (3 * triangle + corner, as in MeshEdges.h) in increasing
+ * triangle order, so a value per vertex can be computed as a gather over its corners, adding the values of the triangles
+ * in the same order as a loop over the triangles would. The neighbours of a vertex are in increasing index order.
+ */
+struct VertexAdjacency
+{
+    std::vector<int> corners_begin;    // vertices + 1
+    std::vector<int> corners;          // corners of each vertex (triangle = corner / 3)
+    std::vector<int> neighbours_begin; // vertices + 1
+    std::vector<int> neighbours;       // vertices connected to each vertex by an edge
+
+    /**
+     * Number of triangles around a vertex.
+     */
+    int get_triangles_count(int vertex) const
+    {
+        return corners_begin[vertex + 1] - corners_begin[vertex];
+    }
+
+    /**
+     * Number of vertices connected to a vertex.
+     */
+    int get_valence(int vertex) const
+    {
+        return neighbours_begin[vertex + 1] - neighbours_begin[vertex];
+    }
+
+    /**
+     * Free the memory.
+     */
+    void clear()
+    {
+        std::vector<int>().swap(corners_begin);
+        std::vector<int>().swap(corners);
+        std::vector<int>().swap(neighbours_begin);
+        std::vector<int>().swap(neighbours);
+    }
+};
+
+/**
+ * Build the adjacency of the triangles in O(V + F) with counting passes (edges from build_mesh_edges).
+ */
+template <typename TriangleType>
+void build_vertex_adjacency(const std::vector<TriangleType> &triangles, int vertices_count, const MeshEdges &edges, VertexAdjacency &adjacency)
+{
+    // ------- vertex -> corners -------
+    int corners_count = triangles.size() * 3;
+    adjacency.corners_begin.assign(vertices_count + 1, 0);
+    for (int corner = 0; corner < corners_count; corner++)
+        adjacency.corners_begin[triangles[corner / 3].v[corner % 3] + 1]++;
+    for (int i = 0; i < vertices_count; i++)
+        adjacency.corners_begin[i + 1] += adjacency.corners_begin[i];
+
+    std::vector<int> position(adjacency.corners_begin.begin(), adjacency.corners_begin.end() - 1);
+    adjacency.corners.resize(corners_count);
+    for (int corner = 0; corner < corners_count; corner++)
+        adjacency.corners[position[triangles[corner / 3].v[corner % 3]]++] = corner;
+
+    // ------- vertex -> vertices -------
+    // edges are sorted by (edge_v1, edge_v2): the neighbours smaller than a vertex come first, both in increasing order
+    int edges_count = edges.edges_count();
+    adjacency.neighbours_begin.assign(vertices_count + 1, 0);
+    for (int e = 0; e < edges_count; e++)
+    {
+        adjacency.neighbours_begin[edges.edge_v1[e] + 1]++;
+        adjacency.neighbours_begin[edges.edge_v2[e] + 1]++;
+    }
+    for (int i = 0; i < vertices_count; i++)
+        adjacency.neighbours_begin[i + 1] += adjacency.neighbours_begin[i];
+
+    position.assign(adjacency.neighbours_begin.begin(), adjacency.neighbours_begin.end() - 1);
+    adjacency.neighbours.resize(edges_count * 2);
+    for (int e = 0; e < edges_count; e++)
+    {
+        adjacency.neighbours[position[edges.edge_v1[e]]++] = edges.edge_v2[e];
+        adjacency.neighbours[position[edges.edge_v2[e]]++] = edges.edge_v1[e];
+    }
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef VERTEXPOSITIONS_H
+#define VERTEXPOSITIONS_H
+
+#include "Point3.h"
+#include "ParallelFor.h"
+#include <vector>
+#include <stdlib.h>
+#include <stdint.h>
+#include <new>
+
+/***************************************************************************
+VertexPositions.h
+Comment:  This file contains the positions of the vertices of a mesh as structure of arrays.
+***************************************************************************/
+
+/**
+ * The positions are rescaled between -1 and 1 once (see get_rescaled_value in LoaderObject.h) and stored as three
+ * arrays x[], y[], z[] of Scalar (the precision of the curvature engine, see BasicMeshCurvature), each one aligned to
+ * VERTEX_POSITIONS_ALIGNMENT bytes: with floats 12 bytes per vertex instead of the 24 of a Point3d, and loops over the
+ * vertices read consecutive values (vector loads, gathers) without the checks of Point3d::operator[].
+ */
+
+const size_t VERTEX_POSITIONS_ALIGNMENT = 32; // one AVX register
+
+/**
+ * Allocator of memory aligned to Alignment bytes (the block returned by malloc is kept just before the pointer).
+ */
+template <typename Value, size_t Alignment>
+struct AlignedAllocator
+{
+    typedef Value value_type;
+
+    template <typename Other>
+    struct rebind
+    {
+        typedef AlignedAllocator<Other, Alignment> other;
+    };
+
+    AlignedAllocator() {}
+
+    template <typename Other>
+    AlignedAllocator(const AlignedAllocator<Other, Alignment> &) {}
+
+    Value *allocate(size_t count)
+    {
+        void *block = malloc(count * sizeof(Value) + Alignment + sizeof(void *));
+        if (!block)
+            throw std::bad_alloc();
+        uintptr_t address = ((uintptr_t)block + sizeof(void *) + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+        ((void **)address)[-1] = block;
+        return (Value *)address;
+    }
+
+    void deallocate(Value *pointer, size_t)
+    {
+        if (pointer)
+            free(((void **)pointer)[-1]);
+    }
+
+    template <typename Other>
+    bool operator==(const AlignedAllocator<Other, Alignment> &) const
+    {
+        return true;
+    }
+
+    template <typename Other>
+    bool operator!=(const AlignedAllocator<Other, Alignment> &) const
+    {
+        return false;
+    }
+};
+
+template <typename Value>
+using AlignedVector = std::vector<Value, AlignedAllocator<Value, VERTEX_POSITIONS_ALIGNMENT> >;
+
+/**
+ * Rescaled positions of the vertices.
+ */
+template <typename Scalar>
+struct VertexPositions
+{
+    AlignedVector<Scalar> x;
+    AlignedVector<Scalar> y;
+    AlignedVector<Scalar> z;
+
+    int size() const
+    {
+        return x.size();
+    }
+
+    /**
+     * Position of a vertex.
+     */
+    Point3<Scalar> get(int vertex) const
+    {
+        return Point3<Scalar>(x[vertex], y[vertex], z[vertex]);
+    }
+
+    /**
+     * Bytes used by the positions.
+     */
+    size_t get_memory_size() const
+    {
+        return (x.capacity() + y.capacity() + z.capacity()) * sizeof(Scalar);
+    }
+
+    /**
+     * Free the memory.
+     */
+    void clear()
+    {
+        AlignedVector<Scalar>().swap(x);
+        AlignedVector<Scalar>().swap(y);
+        AlignedVector<Scalar>().swap(z);
+    }
+};
+
+/**
+ * Rescale the vertices between -1 and 1 (min_coord and max_coord are the minimum and the maximum value found in the mesh)
+ * into positions, with threads_count threads. The same operations as get_rescaled_value (in double), then rounded to Scalar.
+ */
+template <typename Scalar>
+void build_vertex_positions(const std::vector<Point3d> &vertices, double min_coord, double max_coord, int interval, VertexPositions<Scalar> &positions, int threads_count)
+{
+    int vertices_count = vertices.size();
+    positions.x.resize(vertices_count);
+    positions.y.resize(vertices_count);
+    positions.z.resize(vertices_count);
+    double scale = interval / (max_coord - min_coord);
+    parallel_for(vertices_count, threads_count, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            positions.x[i] = scale * (vertices[i].x() - max_coord) + 1;
+            positions.y[i] = scale * (vertices[i].y() - max_coord) + 1;
+            positions.z[i] = scale * (vertices[i].z() - max_coord) + 1;
+        }
+    });
+}
+
+#endif
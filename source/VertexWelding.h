@@ -0,0 +1,114 @@
+#ifndef VERTEXWELDING_H
+#define VERTEXWELDING_H
+
+#include "Point3.h"
+#include <vector>
+#include <unordered_map>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+/***************************************************************************
+VertexWelding.h
+Comment:  This file merges coincident vertices of triangle soups (STL-like meshes).
+***************************************************************************/
+
+/**
+ * A vertex closer than tolerance (on each axis) to a vertex already welded is merged into it, found with a spatial hash:
+ * the space is divided in cubes of side tolerance and a vertex is compared with the vertices of its cube
+ * and of the 26 cubes around it. With tolerance 0 only vertices with the same coordinates are merged.
+ * The welded vertices keep the order of their first occurrence; triangles are remapped and the triangles
+ * that become degenerate (two equal indices) are removed.
+ */
+
+/**
+ * Hash of the cube (x, y, z) of the grid.
+ */
+inline uint64_t get_welding_cell_key(int64_t x, int64_t y, int64_t z)
+{
+    uint64_t key = (uint64_t)x * 0x9E3779B97F4A7C15ULL;
+    key ^= (uint64_t)y * 0xC2B2AE3D27D4EB4FULL + (key << 6) + (key >> 2);
+    key ^= (uint64_t)z * 0x165667B19E3779F9ULL + (key << 6) + (key >> 2);
+    return key;
+}
+
+/**
+ * Key of a coordinate for exact welding (0.0 and -0.0 are the same coordinate).
+ */
+inline int64_t get_welding_exact_coordinate(double value)
+{
+    if (value == 0)
+        value = 0;
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * Weld the vertices of in_v/in_t in place. Return the number of removed degenerate triangles.
+ */
+template <typename TriangleType>
+int weld_vertices(std::vector<Point3d> &in_v, std::vector<TriangleType> &in_t, double tolerance)
+{
+    bool is_exact = !(tolerance > 0);
+    std::vector<int> remap(in_v.size());
+    std::vector<Point3d> welded_v;
+    welded_v.reserve(in_v.size());
+
+    // cell -> last welded vertex of the cell, next_in_cell links the other vertices of the same cell
+    // (different cells with the same hash share the list, they are told apart by the coordinates)
+    std::unordered_map<uint64_t, int> last_in_cell;
+    last_in_cell.reserve(in_v.size());
+    std::vector<int> next_in_cell;
+    next_in_cell.reserve(in_v.size());
+
+    for (size_t i = 0; i < in_v.size(); i++)
+    {
+        const Point3d &p = in_v[i];
+        int64_t cell[3];
+        for (int j = 0; j < 3; j++)
+            cell[j] = is_exact ? get_welding_exact_coordinate(p[j]) : (int64_t)floor(p[j] / tolerance);
+
+        int found = -1;
+        int range = is_exact ? 0 : 1;
+        for (int dx = -range; dx <= range && found < 0; dx++)
+            for (int dy = -range; dy <= range && found < 0; dy++)
+                for (int dz = -range; dz <= range && found < 0; dz++)
+                {
+                    std::unordered_map<uint64_t, int>::iterator it = last_in_cell.find(get_welding_cell_key(cell[0] + dx, cell[1] + dy, cell[2] + dz));
+                    for (int k = (it == last_in_cell.end()) ? -1 : it->second; k >= 0 && found < 0; k = next_in_cell[k])
+                    {
+                        const Point3d &q = welded_v[k];
+                        if (is_exact ? (p == q) : (fabs(p.x() - q.x()) <= tolerance && fabs(p.y() - q.y()) <= tolerance && fabs(p.z() - q.z()) <= tolerance))
+                            found = k;
+                    }
+                }
+
+        if (found < 0)
+        {
+            found = welded_v.size();
+            welded_v.push_back(p);
+            uint64_t key = get_welding_cell_key(cell[0], cell[1], cell[2]);
+            std::unordered_map<uint64_t, int>::iterator it = last_in_cell.find(key);
+            next_in_cell.push_back(it == last_in_cell.end() ? -1 : it->second);
+            last_in_cell[key] = found;
+        }
+        remap[i] = found;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < in_t.size(); i++)
+    {
+        TriangleType triangle = in_t[i];
+        for (int j = 0; j < 3; j++)
+            triangle.v[j] = remap[triangle.v[j]];
+        if (triangle.v[0] != triangle.v[1] && triangle.v[1] != triangle.v[2] && triangle.v[2] != triangle.v[0])
+            in_t[kept++] = triangle;
+    }
+    int removed = in_t.size() - kept;
+    in_t.resize(kept);
+    in_v.swap(welded_v);
+    return removed;
+}
+
+#endif
@@ -0,0 +1,1895 @@
+/**
+    Benchmarks of the mesh loader (no window is created).
+    make benchmark && ./benchmark readers
+    Costanza Volpini
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <map>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "LoaderObject.h"
+#include "CurvatureCache.h"
+#include "StreamingCurvature.h"
+#include "MultiScaleCurvature.h"
+#include "Object.h"
+
+using namespace std;
+
+/**
+ * Find all the files with the given extension inside a folder and its subfolders.
+ */
+void find_files(const string &folder, const string &extension, vector<string> &files)
+{
+    DIR *dir = opendir(folder.c_str());
+    if (!dir)
+        return;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        string name = entry->d_name;
+        if (name == "." || name == "..")
+            continue;
+
+        string path = folder + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0)
+            continue;
+
+        if (S_ISDIR(info.st_mode))
+            find_files(path, extension, files);
+        else if (name.size() > extension.size() && name.compare(name.size() - extension.size(), extension.size(), extension) == 0)
+            files.push_back(path);
+    }
+    closedir(dir);
+    sort(files.begin(), files.end());
+}
+
+/**
+ * Return the best time (milliseconds) of a function over some runs.
+ */
+template <typename Function>
+double best_time_ms(int runs, Function function)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; i++)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        function();
+        auto stop = chrono::high_resolution_clock::now();
+        best = min(best, chrono::duration<double, milli>(stop - start).count());
+    }
+    return best;
+}
+
+/**
+ * Compare the stream reader (read_off_file) with the memory mapped reader of load() (read_mesh_file, which parses
+ * the .OFF files with parse_off_buffer_parallel) on every model under models/: load time and equality of v and t.
+ */
+void benchmark_readers(int runs)
+{
+    MeshCurvature mesh;
+    vector<string> files;
+    find_files("models", ".off", files);
+
+    printf("%-48s %10s %12s %12s %8s %6s\n", "model", "size (KB)", "stream (ms)", "mapped (ms)", "speedup", "same");
+
+    double total_stream = 0, total_mapped = 0;
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        const char *path = files[i].c_str();
+
+        vector<Point3d> stream_v;
+        vector<Triangle> stream_t;
+        double time_stream = best_time_ms(runs, [&]() {
+            mesh.clean();
+            read_off_file(path, mesh.v, mesh.t);
+        });
+        stream_v.swap(mesh.v);
+        stream_t.swap(mesh.t);
+
+        double time_mapped = best_time_ms(runs, [&]() {
+            mesh.clean();
+            mesh.read_mesh_file(path);
+        });
+
+        bool same = stream_v.size() == mesh.v.size() && stream_t.size() == mesh.t.size();
+        for (size_t k = 0; same && k < mesh.v.size(); k++)
+            same = mesh.v[k] == stream_v[k];
+        for (size_t k = 0; same && k < mesh.t.size(); k++)
+            same = mesh.t[k].v[0] == stream_t[k].v[0] && mesh.t[k].v[1] == stream_t[k].v[1] && mesh.t[k].v[2] == stream_t[k].v[2];
+
+        struct stat info;
+        stat(path, &info);
+        printf("%-48s %10.1f %12.3f %12.3f %7.1fx %6s\n", path, info.st_size / 1024.0, time_stream, time_mapped, time_stream / time_mapped, same ? "yes" : "no");
+
+        total_stream += time_stream;
+        total_mapped += time_mapped;
+        mesh.clean();
+    }
+    printf("%-48s %10s %12.3f %12.3f %7.1fx\n", "total", "", total_stream, total_mapped, total_stream / total_mapped);
+}
+
+/**
+ * Time the OFF parser with an increasing number of threads on the biggest models.
+ */
+void benchmark_parser_threads(int runs)
+{
+    MeshCurvature mesh;
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off"};
+    int max_threads = max(1u, thread::hardware_concurrency());
+
+    printf("%-24s %8s %12s %8s\n", "model", "threads", "time (ms)", "speedup");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        MappedFile file;
+        if (!file.open(models[i]))
+            continue;
+
+        double time_one_thread = 0;
+        for (int threads = 1; threads <= max_threads; threads *= 2)
+        {
+            double time = best_time_ms(runs, [&]() {
+                mesh.clean();
+                parse_off_buffer_parallel(file.begin(), file.end(), mesh.v, mesh.t, threads, 0);
+            });
+            if (threads == 1)
+                time_one_thread = time;
+            printf("%-24s %8d %12.3f %7.1fx\n", models[i], threads, time, time_one_thread / time);
+        }
+        mesh.clean();
+    }
+}
+
+/**
+ * Throughput (MB/s) of the number parsing: every token of the file is converted to a double with
+ * an istream (operator >>), with strtod and with MeshTokenizer; the last column parses the whole OFF file.
+ */
+void benchmark_tokenizer(int runs)
+{
+    MeshCurvature mesh;
+    const char *models[] = {"models/armadillo.off", "models/horse.off", "models/genus3.off"};
+
+    printf("%-24s %10s %14s %14s %14s %14s\n", "model", "size (MB)", "istream MB/s", "strtod MB/s", "tokenizer MB/s", "OFF parse MB/s");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        MappedFile file;
+        if (!file.open(models[i]))
+            continue;
+        string text(file.begin(), file.end());
+        double megabytes = file.size() / (1024.0 * 1024.0);
+        volatile double sink = 0;
+
+        double time_istream = best_time_ms(runs, [&]() {
+            istringstream in(text);
+            string header;
+            in >> header;
+            double value, sum = 0;
+            while (in >> value)
+                sum += value;
+            sink = sum;
+        });
+
+        double time_strtod = best_time_ms(runs, [&]() {
+            const char *p = text.c_str() + 3;
+            char *next;
+            double sum = 0;
+            while (true)
+            {
+                double value = strtod(p, &next);
+                if (next == p)
+                    break;
+                sum += value;
+                p = next;
+            }
+            sink = sum;
+        });
+
+        double time_tokenizer = best_time_ms(runs, [&]() {
+            MeshTokenizer tokenizer(file.begin() + 3, file.end());
+            double value, sum = 0;
+            while (tokenizer.next_double(value))
+                sum += value;
+            sink = sum;
+        });
+
+        double time_parse = best_time_ms(runs, [&]() {
+            mesh.clean();
+            parse_off_buffer(file.begin(), file.end(), mesh.v, mesh.t);
+        });
+        mesh.clean();
+
+        printf("%-24s %10.2f %14.1f %14.1f %14.1f %14.1f\n", models[i], megabytes, megabytes / time_istream * 1000, megabytes / time_strtod * 1000, megabytes / time_tokenizer * 1000, megabytes / time_parse * 1000);
+    }
+}
+
+/**
+ * Time of a mesh read from the .OFF file and from its binary cache.
+ */
+void benchmark_mesh_cache(int runs)
+{
+    MeshCurvature mesh;
+    const char *models[] = {"models/armadillo.off", "models/eight.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off"};
+
+    printf("%-28s %10s %12s %8s %6s\n", "model", "OFF (ms)", "cache (ms)", "speedup", "same");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        double time_off = best_time_ms(runs, [&]() {
+            mesh.clean();
+            mesh.read_mesh_file(models[i]);
+        });
+        vector<Point3d> off_v(mesh.v);
+        vector<Triangle> off_t(mesh.t);
+
+        write_mesh_cache(models[i], mesh.v, mesh.t);
+        double time_cache = best_time_ms(runs, [&]() {
+            mesh.clean();
+            read_mesh_cache(models[i], mesh.v, mesh.t);
+        });
+
+        bool same = off_v.size() == mesh.v.size() && off_t.size() == mesh.t.size();
+        for (size_t k = 0; same && k < mesh.v.size(); k++)
+            same = mesh.v[k] == off_v[k];
+        for (size_t k = 0; same && k < mesh.t.size(); k++)
+            same = mesh.t[k].v[0] == off_t[k].v[0] && mesh.t[k].v[1] == off_t[k].v[1] && mesh.t[k].v[2] == off_t[k].v[2];
+
+        printf("%-28s %10.3f %12.3f %7.1fx %6s\n", models[i], time_off, time_cache, time_off / time_cache, same ? "yes" : "no");
+        mesh.clean();
+    }
+}
+
+/**
+ * Time of the results of load() computed from the mesh and read from the curvature cache.
+ * The cache written here is removed at the end (its k-percentile bounds are not computed).
+ */
+void benchmark_curvature_cache(int runs)
+{
+    MeshCurvature mesh;
+    const char *models[] = {"models/armadillo.off", "models/eight.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off"};
+
+    printf("%-28s %10s %12s %8s %6s\n", "model", "load (ms)", "cache (ms)", "speedup", "same");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        vector<float> loaded[CURVATURE_CACHE_ARRAYS], cached[CURVATURE_CACHE_ARRAYS];
+        vector<float> *loaded_arrays[CURVATURE_CACHE_ARRAYS], *cached_arrays[CURVATURE_CACHE_ARRAYS];
+        for (int k = 0; k < CURVATURE_CACHE_ARRAYS; k++)
+        {
+            loaded_arrays[k] = &loaded[k];
+            cached_arrays[k] = &cached[k];
+        }
+
+        double time_load = best_time_ms(runs, [&]() {
+            for (int k = 0; k < CURVATURE_CACHE_ARRAYS; k++)
+                loaded[k].clear();
+            PrincipalCurvatureOutputs principal; // as Object: arrays 9 ... 13
+            mesh.load(models[i], loaded[0], loaded[1], loaded[2], loaded[3], loaded[5], loaded[4], loaded[6], loaded[7], loaded[8], &principal);
+            loaded[9].swap(principal.curvatures);
+            loaded[10].swap(principal.directions_1);
+            loaded[11].swap(principal.directions_2);
+            loaded[12].swap(principal.curvatures_vertex);
+            loaded[13].swap(principal.directions_vertex);
+        });
+
+        double bounds[CURVATURE_CACHE_BOUNDS] = {0, 0, 0, 0, 0, 0};
+        write_curvature_cache(models[i], mesh.get_settings_key(), loaded_arrays, bounds);
+        double time_cache = best_time_ms(runs, [&]() {
+            read_curvature_cache(models[i], mesh.get_settings_key(), cached_arrays, bounds);
+        });
+        remove(get_curvature_cache_path(models[i]).c_str());
+
+        bool same = true;
+        for (int k = 0; k < CURVATURE_CACHE_ARRAYS; k++)
+            same = same && loaded[k] == cached[k];
+
+        printf("%-28s %10.3f %12.3f %7.1fx %6s\n", models[i], time_load, time_cache, time_load / time_cache, same ? "yes" : "no");
+    }
+}
+
+/**
+ * Streaming mode (load_streaming) with a small and a big memory budget compared with load(): Gaussian and mean curvature
+ * per vertex must be the same (both compute the triangles with the same kernel, see use_simd_kernel).
+ */
+void benchmark_streaming(int runs)
+{
+    MeshCurvature mesh;
+    const char *models[] = {"models/armadillo.off", "models/eight.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off", "models/Objects/head.off"};
+    const size_t budgets[] = {64 << 10, 256 << 20};
+    const char *output_path = "streaming.curvature";
+
+    printf("%-28s %12s %12s %14s %6s\n", "model", "budget (KB)", "load (ms)", "streaming (ms)", "same");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        vector<float> out[9];
+        double time_load = best_time_ms(runs, [&]() {
+            for (int k = 0; k < 9; k++)
+                out[k].clear();
+            mesh.clean();
+            mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]);
+        });
+        mesh.clean();
+
+        for (size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++)
+        {
+            double time_streaming = best_time_ms(runs, [&]() {
+                load_streaming(models[i], output_path, budgets[b]);
+            });
+
+            MappedFile result;
+            bool same = result.open(output_path) && result.size() == (out[6].size() + out[8].size()) * sizeof(float) &&
+                        memcmp(result.begin(), &out[6][0], out[6].size() * sizeof(float)) == 0 &&
+                        memcmp(result.begin() + out[6].size() * sizeof(float), &out[8][0], out[8].size() * sizeof(float)) == 0;
+            printf("%-28s %12zu %12.3f %14.3f %6s\n", models[i], budgets[b] >> 10, time_load, time_streaming, same ? "yes" : "no");
+        }
+        remove(output_path);
+    }
+}
+
+/**
+ * Write v and t as a PLY file: binary (little or big endian, double or float coordinates) or ascii.
+ */
+bool write_ply_file(const char *path, const vector<Point3d> &v, const vector<Triangle> &t, const char *format, bool is_double)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+    const char *type = is_double ? "double" : "float";
+    fprintf(file, "ply\nformat %s 1.0\ncomment benchmark\nelement vertex %zu\nproperty %s x\nproperty %s y\nproperty %s z\n", format, v.size(), type, type, type);
+    fprintf(file, "element face %zu\nproperty list uchar int vertex_indices\nend_header\n", t.size());
+
+    bool is_ascii = strcmp(format, "ascii") == 0;
+    bool is_swapped = strcmp(format, "binary_big_endian") == 0;
+    vector<char> bytes;
+    for (size_t i = 0; i < v.size(); i++)
+    {
+        if (is_ascii)
+        {
+            fprintf(file, "%.17g %.17g %.17g\n", v[i].x(), v[i].y(), v[i].z());
+            continue;
+        }
+        for (int j = 0; j < 3; j++)
+        {
+            char value[8];
+            double coordinate = v[i][j];
+            float coordinate_float = coordinate;
+            size_t size = is_double ? 8 : 4;
+            memcpy(value, is_double ? (const void *)&coordinate : (const void *)&coordinate_float, size);
+            if (is_swapped)
+                reverse(value, value + size);
+            bytes.insert(bytes.end(), value, value + size);
+        }
+    }
+    for (size_t i = 0; i < t.size(); i++)
+    {
+        if (is_ascii)
+        {
+            fprintf(file, "3 %d %d %d\n", t[i].v[0], t[i].v[1], t[i].v[2]);
+            continue;
+        }
+        bytes.push_back(3);
+        for (int j = 0; j < 3; j++)
+        {
+            char value[4];
+            memcpy(value, &t[i].v[j], 4);
+            if (is_swapped)
+                reverse(value, value + 4);
+            bytes.insert(bytes.end(), value, value + 4);
+        }
+    }
+    bool is_written = bytes.empty() || fwrite(&bytes[0], 1, bytes.size(), file) == bytes.size();
+    return (fclose(file) == 0) && is_written;
+}
+
+/**
+ * Write v and t as an OBJ file.
+ */
+bool write_obj_file(const char *path, const vector<Point3d> &v, const vector<Triangle> &t)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+    fprintf(file, "# benchmark\n");
+    for (size_t i = 0; i < v.size(); i++)
+        fprintf(file, "v %.17g %.17g %.17g\n", v[i].x(), v[i].y(), v[i].z());
+    for (size_t i = 0; i < t.size(); i++)
+        fprintf(file, "f %d %d %d\n", t[i].v[0] + 1, t[i].v[1] + 1, t[i].v[2] + 1);
+    return fclose(file) == 0;
+}
+
+/**
+ * Time of a mesh read from OFF, PLY (binary and ascii) and OBJ files written from the same v and t.
+ */
+void benchmark_formats(int runs)
+{
+    MeshCurvature mesh;
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off"};
+    const char *formats[] = {"binary_little_endian", "binary_big_endian", "ascii"};
+
+    printf("%-24s %-32s %12s %10s %6s\n", "model", "format", "size (MB)", "time (ms)", "same");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        mesh.clean();
+        if (!mesh.read_mesh_file(models[i]))
+            continue;
+        vector<Point3d> off_v(mesh.v);
+        vector<Triangle> off_t(mesh.t);
+
+        vector<string> paths, names;
+        paths.push_back(models[i]);
+        names.push_back("OFF");
+        for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+        {
+            for (int is_double = 1; is_double >= 0; is_double--)
+            {
+                if (!is_double && strcmp(formats[f], "ascii") == 0)
+                    continue;
+                string path = string("benchmark_") + formats[f] + (is_double ? "_double" : "_float") + ".ply";
+                if (write_ply_file(path.c_str(), mesh.v, mesh.t, formats[f], is_double))
+                {
+                    paths.push_back(path);
+                    names.push_back(string("PLY ") + formats[f] + (is_double ? "" : " float"));
+                }
+            }
+        }
+        if (write_obj_file("benchmark.obj", mesh.v, mesh.t))
+        {
+            paths.push_back("benchmark.obj");
+            names.push_back("OBJ");
+        }
+
+        for (size_t f = 0; f < paths.size(); f++)
+        {
+            double time = best_time_ms(runs, [&]() {
+                mesh.clean();
+                mesh.read_mesh_file(paths[f].c_str());
+            });
+
+            // float files are compared with the coordinates rounded to float
+            bool is_float = names[f].find("float") != string::npos;
+            bool same = mesh.v.size() == off_v.size() && mesh.t.size() == off_t.size();
+            for (size_t k = 0; same && k < mesh.v.size(); k++)
+                same = is_float ? mesh.v[k] == Point3d((float)off_v[k].x(), (float)off_v[k].y(), (float)off_v[k].z()) : mesh.v[k] == off_v[k];
+            for (size_t k = 0; same && k < mesh.t.size(); k++)
+                same = mesh.t[k].v[0] == off_t[k].v[0] && mesh.t[k].v[1] == off_t[k].v[1] && mesh.t[k].v[2] == off_t[k].v[2];
+
+            struct stat info;
+            stat(paths[f].c_str(), &info);
+            printf("%-24s %-32s %12.2f %10.3f %6s\n", models[i], names[f].c_str(), info.st_size / (1024.0 * 1024.0), time, same ? "yes" : "no");
+            if (f > 0)
+                remove(paths[f].c_str());
+        }
+        mesh.clean();
+    }
+}
+
+/**
+ * Welding of triangle soups: every model is written with 3 new vertices per triangle, welded again
+ * and loaded with load(); the values per triangle must be the same as the ones of the original model.
+ */
+void benchmark_welding(int runs)
+{
+    MeshCurvature mesh;
+    mesh.use_mesh_cache = false;
+    const char *models[] = {"models/armadillo.off", "models/eight.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off"};
+    const char *soup_path = "benchmark_soup.off";
+
+    printf("%-28s %10s %10s %10s %10s %6s\n", "model", "vertices", "soup", "welded", "weld (ms)", "same");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        mesh.clean();
+        if (!mesh.read_mesh_file(models[i]))
+            continue;
+        size_t vertices_count = mesh.v.size();
+
+        vector<Point3d> soup_v;
+        vector<Triangle> soup_t(mesh.t.size());
+        for (size_t k = 0; k < mesh.t.size(); k++)
+            for (int j = 0; j < 3; j++)
+            {
+                soup_t[k].v[j] = soup_v.size();
+                soup_v.push_back(mesh.v[mesh.t[k].v[j]]);
+            }
+
+        FILE *file = fopen(soup_path, "w");
+        if (!file)
+            continue;
+        fprintf(file, "OFF\n%zu %zu 0\n", soup_v.size(), soup_t.size());
+        for (size_t k = 0; k < soup_v.size(); k++)
+            fprintf(file, "%.17g %.17g %.17g\n", soup_v[k].x(), soup_v[k].y(), soup_v[k].z());
+        for (size_t k = 0; k < soup_t.size(); k++)
+            fprintf(file, "3 %d %d %d\n", soup_t[k].v[0], soup_t[k].v[1], soup_t[k].v[2]);
+        fclose(file);
+
+        vector<Point3d> welded_v;
+        vector<Triangle> welded_t;
+        double time_weld = best_time_ms(runs, [&]() {
+            welded_v = soup_v;
+            welded_t = soup_t;
+            weld_vertices(welded_v, welded_t, 0.0);
+        });
+
+        vector<float> original[9], welded[9];
+        mesh.clean();
+        mesh.load(models[i], original[0], original[1], original[2], original[3], original[4], original[5], original[6], original[7], original[8]);
+        mesh.clean();
+        mesh.use_vertex_welding = true;
+        mesh.load(soup_path, welded[0], welded[1], welded[2], welded[3], welded[4], welded[5], welded[6], welded[7], welded[8]);
+        mesh.use_vertex_welding = false;
+        mesh.clean();
+
+        // values per triangle (the values per vertex are in the order of the welded vertices)
+        bool same = true;
+        for (int k = 0; k < 9; k++)
+            if (k != 6 && k != 8)
+                same = same && original[k] == welded[k];
+
+        printf("%-28s %10zu %10zu %10zu %10.3f %6s\n", models[i], vertices_count, soup_v.size(), welded_v.size(), time_weld, same ? "yes" : "no");
+    }
+    remove(soup_path);
+}
+
+/**
+ * Fields of an edge when the edges were kept in a std::map<vector<int>, edge>.
+ */
+struct map_edge_value
+{
+    float norm_edge;
+    int index_v1;
+    int index_v2;
+    Point3d n1;
+    Point3d n2;
+    float value_mean_curvature;
+    float cot_alpha;
+    float cot_beta;
+    float area_t1;
+    float area_t2;
+};
+
+/**
+ * Edge phase of load() (find the edges of the 3 corners of every triangle, then the 2 passes of 3 lookups
+ * per triangle) with a std::map<vector<int>, edge> and with the sorted corners of MeshEdges, which replaced it.
+ */
+void benchmark_edges(int runs)
+{
+    MeshCurvature mesh;
+    const char *models[] = {"models/armadillo.off", "models/horse.off"};
+
+    printf("%-28s %10s %14s %14s\n", "model", "edges", "std::map (ms)", "sorted (ms)");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        mesh.clean();
+        if (!mesh.read_mesh_file(models[i]))
+            continue;
+
+        size_t edges_count = 0;
+        double sum_map = 0, sum_sorted = 0;
+        double time_map = best_time_ms(runs, [&]() {
+            std::map<vector<int>, map_edge_value> map_edge;
+            for (int k = 0; k < mesh.num_triangles; k++)
+                for (int j = 0; j < 3; j++)
+                {
+                    int index_v1 = mesh.t[k].v[j], index_v2 = mesh.t[k].v[(j + 1) % 3];
+                    vector<int> key = {min(index_v1, index_v2), max(index_v1, index_v2)};
+                    std::map<vector<int>, map_edge_value>::iterator it = map_edge.find(key);
+                    if (it != map_edge.end())
+                        it->second.value_mean_curvature += 1.0f;
+                    else
+                    {
+                        map_edge_value e = map_edge_value();
+                        e.index_v1 = key[0];
+                        e.index_v2 = key[1];
+                        map_edge[key] = e;
+                    }
+                }
+            for (int pass = 0; pass < 2; pass++)
+                for (int k = 0; k < mesh.num_triangles; k++)
+                    for (int j = 0; j < 3; j++)
+                    {
+                        int index_v1 = mesh.t[k].v[j], index_v2 = mesh.t[k].v[(j + 1) % 3];
+                        sum_map += map_edge.find({min(index_v1, index_v2), max(index_v1, index_v2)})->second.value_mean_curvature;
+                    }
+            edges_count = map_edge.size();
+        });
+
+        double time_sorted = best_time_ms(runs, [&]() {
+            MeshEdges edges;
+            build_mesh_edges(mesh.t, mesh.num_vertices, edges);
+            vector<float> values(edges.edges_count());
+            for (int e = 0; e < edges.edges_count(); e++)
+                values[e] = edges.sides_begin[e + 1] - edges.sides_begin[e] - 1;
+            for (int pass = 0; pass < 2; pass++)
+                for (int corner = 0; corner < mesh.num_triangles * 3; corner++)
+                    sum_sorted += values[edges.corner_edges[corner]];
+        });
+
+        if (sum_map != sum_sorted)
+            cout << "different values for " << models[i] << endl;
+        printf("%-28s %10zu %14.3f %14.3f\n", models[i], edges_count, time_map, time_sorted);
+    }
+    mesh.clean();
+}
+
+/**
+ * One-rings: build time of the vertex adjacency, the triangles of 100 vertices found in it and by searching the
+ * triangles, and the triangles of every edge from get_triangle_by_edge (answered from the vertex adjacency, with the
+ * edges freed by load()) compared with the sides of the edge in MeshEdges.
+ */
+void benchmark_one_ring(int runs)
+{
+    MeshCurvature mesh;
+    mesh.use_incremental_updates = false;
+    const char *models[] = {"models/armadillo.off", "models/eight.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off"};
+
+    printf("%-28s %10s %12s %14s %18s %14s %6s\n", "model", "vertices", "build (ms)", "adjacency 100", "search 100 (ms)", "edges (ms)", "same");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        mesh.clean();
+        vector<float> out[9];
+        if (!mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]))
+            continue;
+
+        MeshEdges edges;
+        build_mesh_edges(mesh.t, mesh.num_vertices, edges);
+        VertexAdjacency adjacency;
+        double time_build = best_time_ms(runs, [&]() {
+            build_vertex_adjacency(mesh.t, mesh.num_vertices, edges, adjacency);
+        });
+
+        int step = max(1, mesh.num_vertices / 100);
+        vector<vector<int> > gathered, searched;
+        double time_adjacency = best_time_ms(runs, [&]() {
+            gathered.clear();
+            for (int vertex = 0; vertex < mesh.num_vertices; vertex += step)
+            {
+                vector<int> triangles;
+                for (int c = adjacency.corners_begin[vertex]; c < adjacency.corners_begin[vertex + 1]; c++)
+                    triangles.push_back(adjacency.corners[c] / 3);
+                gathered.push_back(triangles);
+            }
+        });
+        double time_search = best_time_ms(runs, [&]() {
+            searched.clear();
+            for (int vertex = 0; vertex < mesh.num_vertices; vertex += step)
+            {
+                vector<int> triangles;
+                for (int k = 0; k < mesh.num_triangles; k++)
+                    if (mesh.t[k].v[0] == vertex || mesh.t[k].v[1] == vertex || mesh.t[k].v[2] == vertex)
+                        triangles.push_back(k);
+                searched.push_back(triangles);
+            }
+        });
+
+        vector<vector<int> > found(edges.edges_count());
+        double time_edges = best_time_ms(runs, [&]() {
+            for (int e = 0; e < edges.edges_count(); e++)
+                found[e] = mesh.get_triangle_by_edge(edges.edge_v1[e], edges.edge_v2[e]);
+        });
+
+        bool same = gathered == searched && mesh.mesh_edges.edges_count() == 0;
+        for (int e = 0; e < edges.edges_count(); e++)
+        {
+            int first = edges.sides_begin[e], sides_count = edges.sides_begin[e + 1] - first;
+            vector<int> expected(2, -1);
+            if (sides_count <= 2)
+                for (int j = 0; j < sides_count; j++)
+                    expected[j] = edges.sides[first + j] / 3;
+            same = same && found[e] == expected;
+        }
+
+        printf("%-28s %10d %12.3f %14.3f %18.3f %14.3f %6s\n", models[i], mesh.num_vertices, time_build, time_adjacency, time_search, time_edges, same ? "yes" : "no");
+    }
+    mesh.clean();
+}
+
+/**
+ * Cache locality reordering: ACMR of the file order and of the reordered mesh, time of the reordering and of load()
+ * without and with it. The triangles of the reordered mesh must be those of the file through vertex_index and
+ * triangle_index ("mapped"), and the curvatures per vertex the same through vertex_index up to the rounding of sums
+ * done in a different order: "diff" is the biggest relative difference.
+ */
+void benchmark_reorder(int runs)
+{
+    MeshCurvature mesh;
+    mesh.use_mesh_cache = false;
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off"};
+
+    printf("%-28s %12s %12s %14s %12s %12s %8s %10s\n", "model", "ACMR before", "ACMR after", "reorder (ms)", "load (ms)", "reordered", "mapped", "diff");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        mesh.clean();
+        if (!mesh.read_mesh_file(models[i]))
+            continue;
+        vector<Point3d> file_v = mesh.v;
+        vector<Triangle> file_t = mesh.t;
+
+        ReorderStatistics statistics;
+        double time_reorder = best_time_ms(runs, [&]() {
+            mesh.v = file_v;
+            mesh.t = file_t;
+            statistics = reorder_mesh(mesh.v, mesh.t);
+        });
+
+        vector<float> original[9], reordered[9];
+        double time_load = best_time_ms(runs, [&]() {
+            for (int k = 0; k < 9; k++)
+                original[k].clear();
+            mesh.clean();
+            mesh.load(models[i], original[0], original[1], original[2], original[3], original[4], original[5], original[6], original[7], original[8]);
+        });
+        mesh.use_mesh_reordering = true;
+        double time_load_reordered = best_time_ms(runs, [&]() {
+            for (int k = 0; k < 9; k++)
+                reordered[k].clear();
+            mesh.clean();
+            mesh.load(models[i], reordered[0], reordered[1], reordered[2], reordered[3], reordered[4], reordered[5], reordered[6], reordered[7], reordered[8]);
+        });
+        mesh.use_mesh_reordering = false;
+
+        bool mapped = (int)mesh.vertex_index.size() == mesh.num_vertices && (int)mesh.triangle_index.size() == mesh.num_triangles && file_t.size() == mesh.t.size();
+        for (size_t k = 0; mapped && k < file_t.size(); k++)
+            for (int j = 0; j < 3; j++)
+                mapped = mapped && mesh.t[mesh.get_triangle_index(k)].v[j] == mesh.get_vertex_index(file_t[k].v[j]);
+
+        // gc_vertex_size and mc_vertex_size_vertex
+        double diff = 0;
+        for (int k = 6; k < 9; k += 2)
+        {
+            if (original[k].size() != reordered[k].size())
+                diff = 1e30;
+            for (size_t j = 0; j < original[k].size() && j < reordered[k].size(); j++)
+                diff = max(diff, fabs((double)original[k][j] - reordered[k][mesh.get_vertex_index(j)]) / max(1.0, fabs((double)original[k][j])));
+        }
+
+        printf("%-28s %12.3f %12.3f %14.3f %12.3f %12.3f %8s %10.2g\n", models[i], statistics.acmr_before, statistics.acmr_after, time_reorder, time_load, time_load_reordered, mapped ? "yes" : "no",
+               diff);
+    }
+    mesh.clean();
+}
+
+/**
+ * Largest relative difference between two arrays (relative to max(1, |reference|)).
+ */
+template <typename Value>
+double get_max_relative_difference(const vector<Value> &reference, const vector<Value> &values)
+{
+    double difference = 0;
+    for (size_t i = 0; i < reference.size() && i < values.size(); i++)
+        difference = max(difference, fabs((double)reference[i] - values[i]) / max(1.0, fabs((double)reference[i])));
+    return difference;
+}
+
+/**
+ * Geometry of the triangles (normals, angles, cotangents, areas, Area mixed) with the scalar path and with the
+ * AVX2 kernel, and the biggest relative difference of each value.
+ */
+void benchmark_kernel(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off"};
+    if (!is_avx2_supported())
+        cout << "AVX2 is not supported by this CPU: both columns use the scalar path." << endl;
+
+    printf("%-28s %12s %10s %8s %10s %10s %10s %10s %10s\n", "model", "scalar (ms)", "avx2 (ms)", "speedup", "normal", "angle", "cot", "area", "A mixed");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        MeshCurvature mesh;
+        if (!mesh.read_mesh(models[i]))
+            continue;
+        mesh.set_max_min_mesh();
+        VertexPositions<double> positions;
+        build_vertex_positions(mesh.v, mesh.min_coord, mesh.max_coord, interval, positions, mesh.threads);
+
+        vector<double> angle[2], area_mixed[2], normal[2];
+        vector<double> cot[2], area[2];
+        double time[2];
+        for (int simd = 0; simd < 2; simd++)
+        {
+            angle[simd].resize(mesh.num_triangles * 3);
+            area_mixed[simd].resize(mesh.num_triangles * 3);
+            cot[simd].resize(mesh.num_triangles * 3);
+            area[simd].resize(mesh.num_triangles);
+            TriangleGeometry<double> geometry = {angle[simd].data(), area_mixed[simd].data(), cot[simd].data(), area[simd].data()};
+            time[simd] = best_time_ms(runs, [&]() {
+                compute_triangle_geometry(mesh.t.data(), positions.x.data(), positions.y.data(), positions.z.data(), 0, mesh.num_triangles, geometry, simd == 1);
+            });
+            for (int k = 0; k < mesh.num_triangles; k++)
+                for (int j = 0; j < 3; j++)
+                    normal[simd].push_back(mesh.t[k].n[j]);
+        }
+
+        printf("%-28s %12.3f %10.3f %7.1fx %10.2g %10.2g %10.2g %10.2g %10.2g\n", models[i], time[0], time[1], time[0] / time[1],
+               get_max_relative_difference(normal[0], normal[1]), get_max_relative_difference(angle[0], angle[1]), get_max_relative_difference(cot[0], cot[1]),
+               get_max_relative_difference(area[0], area[1]), get_max_relative_difference(area_mixed[0], area_mixed[1]));
+    }
+}
+
+/**
+ * Memory of the vertices as read (Point3d) and as rescaled float positions, and time to read the rescaled
+ * vertices of every corner from each one.
+ */
+void benchmark_positions(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off"};
+    printf("%-28s %12s %14s %12s %14s %14s\n", "model", "Point3d (KB)", "positions (KB)", "build (ms)", "Point3d (ms)", "positions (ms)");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        MeshCurvature mesh;
+        if (!mesh.read_mesh(models[i]))
+            continue;
+        mesh.set_max_min_mesh();
+
+        VertexPositions<float> positions;
+        double build_time = best_time_ms(runs, [&]() {
+            build_vertex_positions(mesh.v, mesh.min_coord, mesh.max_coord, interval, positions, 1);
+        });
+
+        // sum of the rescaled coords of every corner, as the loops of load() read them
+        double sum[2] = {0, 0};
+        double point_time = best_time_ms(runs, [&]() {
+            sum[0] = 0;
+            for (int k = 0; k < mesh.num_triangles; k++)
+                for (int j = 0; j < 3; j++)
+                {
+                    Point3d vertex = mesh.get_rescaled_value(mesh.v[mesh.t[k].v[j]]);
+                    sum[0] += vertex[0] + vertex[1] + vertex[2];
+                }
+        });
+        double positions_time = best_time_ms(runs, [&]() {
+            sum[1] = 0;
+            for (int k = 0; k < mesh.num_triangles; k++)
+                for (int j = 0; j < 3; j++)
+                {
+                    int vertex = mesh.t[k].v[j];
+                    sum[1] += (double)positions.x[vertex] + positions.y[vertex] + positions.z[vertex];
+                }
+        });
+
+        printf("%-28s %12.0f %14.0f %12.3f %14.3f %14.3f (sums %.6g, %.6g)\n", models[i], mesh.v.size() * sizeof(Point3d) / 1024.0,
+               positions.get_memory_size() / 1024.0, build_time, point_time, positions_time, sum[0], sum[1]);
+    }
+}
+
+// ----- FROZEN BASELINE: geometry of the triangles as load() computed it before get_triangle_corners -----
+// Not used by the viewer and kept unchanged on purpose: benchmark_trig_free measures compute_triangle_geometry
+// (TriangleKernel.h) against it. Do not fix or speed up these functions.
+
+/**
+ * Function to get the cotangent of an angle
+ */
+double get_cotangent(double angle)
+{
+    return cos(angle) / sin(angle);
+}
+
+/**
+ * Get distance between 2 points
+ */
+double get_distance_points(Point3d v0, Point3d v1)
+{
+    return abs(sqrt(pow((v0[0] - v1[0]), 2) + pow((v0[1] - v1[1]), 2) + pow((v0[2] - v1[2]), 2)));
+}
+
+/**
+ * Find area of triangle using Heron's formula.
+ * s = (a + b + c) / 2
+ * A = sqrt(s (s - a) (s - b) (s-c))
+*/
+double get_area_triangle(Point3d v0, Point3d v1, Point3d v2)
+{
+    double edge0 = get_distance_points(v0, v1);
+    double edge1 = get_distance_points(v0, v2);
+    double edge2 = get_distance_points(v1, v2);
+
+    double s = (edge0 + edge1 + edge2) / 2;
+    return sqrt(s * (s - edge0) * (s - edge1) * (s - edge2));
+}
+
+/**
+ * Function to get Voronoi region of vertex P in triangle [P, Q, R].
+ * See paper http://www.geometry.caltech.edu/pubs/DMSB_III.pdf (section 3.3)
+ */
+double get_voronoi_region_triangle(Point3d P, Point3d Q, Point3d R, float Q_angle, float R_angle)
+{
+    double first_part = pow(get_distance_points(P, R), 2) * get_cotangent(Q_angle);
+    double second_part = pow(get_distance_points(P, Q), 2) * get_cotangent(R_angle);
+    return (first_part + second_part) / 8;
+}
+
+/**
+ * Check if an angle is obtuse (radians)
+ */
+bool is_obtuse_angle(float angle)
+{
+    return angle > M_PI / 2 && angle < M_PI;
+}
+
+/**
+ * Calculate the part of Area mixed of vertex P in triangle [P, Q, R], given the 3 angles of the triangle (at P, Q, R)
+ * and its area. The Area mixed of a vertex x is the sum of these parts for each triangle T from the 1-ring neighborhood of x.
+*/
+double get_A_mixed_part(Point3d P, Point3d Q, Point3d R, float current_angle, float other_angle, float other_angle_1, double area_triangle)
+{
+    if (!is_obtuse_angle(current_angle) && !is_obtuse_angle(other_angle) && !is_obtuse_angle(other_angle_1)) // Triangle is not obtuse -> Voronoi-safe
+    {
+        // Voronoi region of x in T
+        return get_voronoi_region_triangle(P, Q, R, other_angle, other_angle_1);
+    }
+    else // Voronoi inappropriate
+    {
+        if (is_obtuse_angle(current_angle)) //obtuse angle
+            return area_triangle / 2;
+        else // not-obtuse triangle
+            return area_triangle / 4;
+    }
+}
+
+/**
+ * Geometry of the triangles as computed before get_triangle_corners: angles from normalized edges (Point3d::getAngle),
+ * cotangents as cos(angle) / sin(angle), area with Heron's formula and obtuse tests on the angles rounded to float.
+ */
+void compute_triangle_geometry_angles(Triangle *triangles, const VertexPositions<double> &positions, int count, const TriangleGeometry<double> &geometry)
+{
+    for (int k = 0; k < count; k++)
+    {
+        Point3d v0 = positions.get(triangles[k].v[0]), v1 = positions.get(triangles[k].v[1]), v2 = positions.get(triangles[k].v[2]);
+        Point3d n = (v1 - v0) ^ (v2 - v0);
+        n.normalize();
+        triangles[k].n = n;
+
+        Point3d v0v1 = v1 - v0;
+        Point3d v0v2 = v2 - v0;
+        v0v1.normalize();
+        v0v2.normalize();
+        Point3d v1v2 = v2 - v1;
+        v1v2.normalize();
+        double angle[3] = {v0v1.getAngle(v0v2), v1v2.getAngle(-v0v1), (-v0v2).getAngle(-v1v2)};
+
+        double area_triangle = get_area_triangle(v0, v1, v2);
+        geometry.triangle_area[k] = area_triangle;
+        geometry.corner_area_mixed[k * 3 + 0] = get_A_mixed_part(v0, v1, v2, angle[0], angle[1], angle[2], area_triangle);
+        geometry.corner_area_mixed[k * 3 + 1] = get_A_mixed_part(v1, v0, v2, angle[1], angle[0], angle[2], area_triangle);
+        geometry.corner_area_mixed[k * 3 + 2] = get_A_mixed_part(v2, v0, v1, angle[2], angle[0], angle[1], area_triangle);
+        for (int c = 0; c < 3; c++)
+        {
+            geometry.corner_angle[k * 3 + c] = angle[c];
+            geometry.corner_cot[k * 3 + c] = get_cotangent(angle[c]);
+        }
+    }
+}
+
+// -------------------------
+
+/**
+ * Angles, cotangents, areas and parts of the Area mixed of the triangles in long double (the formulas of get_triangle_corners).
+ */
+void compute_triangle_geometry_exact(const vector<Triangle> &triangles, const VertexPositions<double> &positions, vector<long double> &angle, vector<long double> &cot, vector<long double> &area, vector<long double> &area_mixed)
+{
+    angle.resize(triangles.size() * 3);
+    cot.resize(triangles.size() * 3);
+    area.resize(triangles.size());
+    area_mixed.resize(triangles.size() * 3);
+    for (size_t k = 0; k < triangles.size(); k++)
+    {
+        long double p[3][3];
+        for (int j = 0; j < 3; j++)
+        {
+            p[j][0] = positions.x[triangles[k].v[j]];
+            p[j][1] = positions.y[triangles[k].v[j]];
+            p[j][2] = positions.z[triangles[k].v[j]];
+        }
+        long double edge[3][3], squared[3] = {0, 0, 0}, dot[3] = {0, 0, 0}; // v0v1, v0v2, v1v2
+        for (int i = 0; i < 3; i++)
+        {
+            edge[0][i] = p[1][i] - p[0][i];
+            edge[1][i] = p[2][i] - p[0][i];
+            edge[2][i] = p[2][i] - p[1][i];
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            for (int e = 0; e < 3; e++)
+                squared[e] += edge[e][i] * edge[e][i];
+            dot[0] += edge[0][i] * edge[1][i];
+            dot[1] -= edge[0][i] * edge[2][i];
+            dot[2] += edge[1][i] * edge[2][i];
+        }
+        long double cross[3] = {edge[0][1] * edge[1][2] - edge[0][2] * edge[1][1], edge[0][2] * edge[1][0] - edge[0][0] * edge[1][2], edge[0][0] * edge[1][1] - edge[0][1] * edge[1][0]};
+        long double cross_norm = sqrtl(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+        area[k] = cross_norm / 2;
+        for (int c = 0; c < 3; c++)
+        {
+            angle[k * 3 + c] = atan2l(cross_norm, dot[c]);
+            cot[k * 3 + c] = dot[c] / cross_norm;
+        }
+        const long double *corner_cot = &cot[k * 3];
+        if (dot[0] >= 0 && dot[1] >= 0 && dot[2] >= 0)
+        {
+            area_mixed[k * 3 + 0] = (squared[1] * corner_cot[1] + squared[0] * corner_cot[2]) / 8;
+            area_mixed[k * 3 + 1] = (squared[2] * corner_cot[0] + squared[0] * corner_cot[2]) / 8;
+            area_mixed[k * 3 + 2] = (squared[2] * corner_cot[0] + squared[1] * corner_cot[1]) / 8;
+        }
+        else
+            for (int c = 0; c < 3; c++)
+                area_mixed[k * 3 + c] = dot[c] < 0 ? area[k] / 2 : area[k] / 4;
+    }
+}
+
+/**
+ * Largest error of values from the exact ones: relative, or relative to max(1, |exact|) if is_relative_to_one
+ * (cotangents are 0 for right angles). Values of degenerate triangles (not finite) are skipped.
+ */
+template <typename Value>
+double get_max_error(const vector<long double> &exact, const vector<Value> &values, bool is_relative_to_one)
+{
+    double error = 0;
+    for (size_t i = 0; i < exact.size(); i++)
+    {
+        if (!isfinite((double)exact[i]) || exact[i] == 0)
+            continue;
+        long double scale = is_relative_to_one ? max(1.0L, fabsl(exact[i])) : fabsl(exact[i]);
+        error = max(error, (double)(fabsl(values[i] - exact[i]) / scale));
+    }
+    return error;
+}
+
+/**
+ * Speed and accuracy of the geometry of the triangles of every model of models/ computed with angles (as before
+ * get_triangle_corners), without angles (scalar) and without angles with AVX2, the errors from the same formulas in
+ * long double (existing / trig-free).
+ */
+void benchmark_trig_free(int runs)
+{
+    vector<string> files;
+    find_files("models", ".off", files);
+    sort(files.begin(), files.end());
+
+    printf("%-44s %9s %9s %9s %19s %19s %19s %19s\n", "model", "angles", "trig-free", "avx2", "angle error", "cot error", "area error", "A mixed error");
+    double total_time[3] = {0, 0, 0}, total_error[4][2] = {{0, 0}, {0, 0}, {0, 0}, {0, 0}};
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        MeshCurvature mesh;
+        mesh.use_mesh_cache = false;
+        if (!mesh.read_mesh(files[i].c_str()) || mesh.num_triangles == 0)
+            continue;
+        mesh.set_max_min_mesh();
+        VertexPositions<double> positions;
+        build_vertex_positions(mesh.v, mesh.min_coord, mesh.max_coord, interval, positions, 1);
+
+        vector<long double> exact[4]; // angle, cot, area, A mixed
+        compute_triangle_geometry_exact(mesh.t, positions, exact[0], exact[1], exact[2], exact[3]);
+
+        double time[3], error[4][2];
+        for (int path = 0; path < 3; path++)
+        {
+            vector<double> angle(mesh.num_triangles * 3), area_mixed(mesh.num_triangles * 3);
+            vector<double> cot(mesh.num_triangles * 3), area(mesh.num_triangles);
+            TriangleGeometry<double> geometry = {angle.data(), area_mixed.data(), cot.data(), area.data()};
+            time[path] = best_time_ms(runs, [&]() {
+                if (path == 0)
+                    compute_triangle_geometry_angles(mesh.t.data(), positions, mesh.num_triangles, geometry);
+                else
+                    compute_triangle_geometry(mesh.t.data(), positions.x.data(), positions.y.data(), positions.z.data(), 0, mesh.num_triangles, geometry, path == 2);
+            });
+            total_time[path] += time[path];
+            if (path == 2)
+                continue;
+            error[0][path] = get_max_error(exact[0], angle, false);
+            error[1][path] = get_max_error(exact[1], cot, true);
+            error[2][path] = get_max_error(exact[2], area, false);
+            error[3][path] = get_max_error(exact[3], area_mixed, false);
+            for (int e = 0; e < 4; e++)
+                total_error[e][path] = max(total_error[e][path], error[e][path]);
+        }
+
+        printf("%-44s %9.3f %9.3f %9.3f", files[i].c_str(), time[0], time[1], time[2]);
+        for (int e = 0; e < 4; e++)
+            printf("   %7.1e / %7.1e", error[e][0], error[e][1]);
+        printf("\n");
+    }
+
+    printf("%-44s %9.3f %9.3f %9.3f", "total (time) / max (errors)", total_time[0], total_time[1], total_time[2]);
+    for (int e = 0; e < 4; e++)
+        printf("   %7.1e / %7.1e", total_error[e][0], total_error[e][1]);
+    printf("\n");
+}
+
+/**
+ * Time of load() with an increasing number of threads (the mesh is read from its cache): the results must be
+ * the same as with one thread.
+ */
+void benchmark_load_threads(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off"};
+    int max_threads = max(4u, thread::hardware_concurrency());
+
+    printf("%-24s %8s %12s %8s %6s\n", "model", "threads", "time (ms)", "speedup", "same");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        vector<float> serial[9];
+        double time_one_thread = 0;
+        for (int threads = 1; threads <= max_threads; threads *= 2)
+        {
+            MeshCurvature mesh;
+            mesh.threads = threads;
+            vector<float> out[9];
+            double time = best_time_ms(runs, [&]() {
+                mesh.clean();
+                mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]);
+            });
+            if (threads == 1)
+            {
+                time_one_thread = time;
+                for (int k = 0; k < 9; k++)
+                    serial[k].swap(out[k]);
+            }
+
+            bool same = true;
+            for (int k = 0; k < 9 && threads > 1; k++)
+                same = same && out[k] == serial[k];
+            printf("%-24s %8d %12.3f %7.1fx %6s\n", models[i], threads, time, time_one_thread / time, same ? "yes" : "no");
+        }
+    }
+}
+
+/**
+ * Reentrant engines: the models are loaded one after the other, then all at the same time, one MeshCurvature
+ * per thread. The results of every model must be the same in both cases.
+ */
+void benchmark_engines(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/eight.off", "models/genus3.off", "models/horse.off", "models/icosahedron_4.off"};
+    const int models_count = sizeof(models) / sizeof(models[0]);
+    vector<vector<float> > sequential(models_count * 9), concurrent(models_count * 9);
+
+    double time_sequential = best_time_ms(runs, [&]() {
+        for (int i = 0; i < models_count; i++)
+        {
+            vector<float> *out = &sequential[i * 9];
+            for (int k = 0; k < 9; k++)
+                out[k].clear();
+            MeshCurvature mesh;
+            mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]);
+        }
+    });
+
+    double time_concurrent = best_time_ms(runs, [&]() {
+        vector<thread> workers;
+        for (int i = 0; i < models_count; i++)
+            workers.push_back(thread([&, i]() {
+                vector<float> *out = &concurrent[i * 9];
+                for (int k = 0; k < 9; k++)
+                    out[k].clear();
+                MeshCurvature mesh;
+                mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]);
+            }));
+        for (size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+    });
+
+    printf("%-28s %6s\n", "model", "same");
+    for (int i = 0; i < models_count; i++)
+    {
+        bool same = true;
+        for (int k = 0; k < 9; k++)
+            same = same && sequential[i * 9 + k] == concurrent[i * 9 + k];
+        printf("%-28s %6s\n", models[i], same ? "yes" : "no");
+    }
+    printf("%d models, %u cores: sequential %.3f ms, concurrent %.3f ms (%.1fx)\n", models_count, thread::hardware_concurrency(), time_sequential, time_concurrent, time_sequential / time_concurrent);
+}
+
+/**
+ * Loads a model with the engine given by visit_mesh_curvature (the mesh is read from its cache).
+ */
+struct PrecisionLoad
+{
+    const char *path;
+    int runs;
+    vector<float> *out;
+    double time;
+
+    template <typename Engine>
+    void operator()(Engine &mesh)
+    {
+        time = best_time_ms(runs, [&]() {
+            for (int k = 0; k < 9; k++)
+                out[k].clear();
+            mesh.clean();
+            mesh.load(path, out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]);
+        });
+    }
+};
+
+/**
+ * Time of load() with each precision of the engine (geometry, accumulation and positions in float or in the precision
+ * of the geometry), and the biggest difference of the curvatures from the ones of the engine of doubles, relative to
+ * max(1, |value|).
+ */
+void benchmark_precision(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off"};
+    const char *positions_names[] = {"geometry", "float"};
+    bool is_float_positions = use_float_positions;
+
+    printf("%-24s %-12s %-12s %-10s %10s %10s %10s %10s\n", "model", "precision", "accumulation", "positions", "time (ms)", "gc", "mc edge", "mc vertex");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        vector<float> reference[9];
+        BasicMeshCurvature<double, double> mesh;
+        if (!mesh.load(models[i], reference[0], reference[1], reference[2], reference[3], reference[4], reference[5], reference[6], reference[7], reference[8]))
+            continue;
+
+        for (int precision = PRECISION_FLOAT; precision <= PRECISION_LONG_DOUBLE; precision++)
+            for (int accumulation = PRECISION_FLOAT; accumulation <= PRECISION_LONG_DOUBLE; accumulation++)
+                for (int positions = 0; positions < 2; positions++)
+                {
+                    vector<float> out[9];
+                    PrecisionLoad load = {models[i], runs, out, 0};
+                    use_float_positions = positions == 1;
+                    visit_mesh_curvature((CurvaturePrecision)precision, (CurvaturePrecision)accumulation, NULL, load);
+                    printf("%-24s %-12s %-12s %-10s %10.3f %10.2g %10.2g %10.2g\n", models[i], precision_names[precision], precision_names[accumulation], positions_names[positions], load.time,
+                           get_max_relative_difference(reference[3], out[3]), get_max_relative_difference(reference[4], out[4]), get_max_relative_difference(reference[5], out[5]));
+                }
+    }
+    use_float_positions = is_float_positions;
+}
+
+/**
+ * Time of load() with an area estimator and a set of curvature estimators (the mesh is read from its cache), and the
+ * biggest difference of each curvature computed from reference (mixed area, all the estimators), relative to max(1, |value|).
+ */
+template <typename AreaEstimator, typename Estimators>
+void print_estimators_row(const char *path, const char *estimators_name, int runs, vector<float> reference[9])
+{
+    BasicMeshCurvature<double, double, AreaEstimator, Estimators> mesh;
+    vector<float> out[9];
+    double time = best_time_ms(runs, [&]() {
+        for (int k = 0; k < 9; k++)
+            out[k].clear();
+        mesh.clean();
+        mesh.load(path, out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]);
+    });
+
+    char difference[3][16] = {"-", "-", "-"};
+    if (Estimators::has_angle_defect)
+        snprintf(difference[0], sizeof(difference[0]), "%.2g", get_max_relative_difference(reference[3], out[3]));
+    if (Estimators::has_dihedral_mean)
+        snprintf(difference[1], sizeof(difference[1]), "%.2g", get_max_relative_difference(reference[4], out[4]));
+    if (Estimators::has_cotan_mean)
+        snprintf(difference[2], sizeof(difference[2]), "%.2g", get_max_relative_difference(reference[5], out[5]));
+    printf("%-24s %-14s %-10s %10.3f %10s %10s %10s\n", path, AreaEstimator::get_name(), estimators_name, time, difference[0], difference[1], difference[2]);
+}
+
+template <typename AreaEstimator>
+void print_area_estimator_rows(const char *path, int runs, vector<float> reference[9])
+{
+    print_estimators_row<AreaEstimator, AllCurvatureEstimators>(path, "all", runs, reference);
+    print_estimators_row<AreaEstimator, GaussianCurvatureEstimator>(path, "gc", runs, reference);
+    print_estimators_row<AreaEstimator, DihedralMeanCurvatureEstimator>(path, "mc edge", runs, reference);
+    print_estimators_row<AreaEstimator, CotanMeanCurvatureEstimator>(path, "mc vertex", runs, reference);
+}
+
+/**
+ * Time of load() with each area estimator and with all or one of the curvature estimators (see CurvatureEstimators.h),
+ * and how much the curvatures differ from the ones of the default engine.
+ */
+void benchmark_estimators(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off"};
+
+    printf("%-24s %-14s %-10s %10s %10s %10s %10s\n", "model", "area", "estimators", "time (ms)", "gc", "mc edge", "mc vertex");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        vector<float> reference[9];
+        MeshCurvature mesh;
+        if (!mesh.load(models[i], reference[0], reference[1], reference[2], reference[3], reference[4], reference[5], reference[6], reference[7], reference[8]))
+            continue;
+
+        print_area_estimator_rows<MixedVoronoiArea>(models[i], runs, reference);
+        print_area_estimator_rows<BarycentricArea>(models[i], runs, reference);
+        print_area_estimator_rows<CircumcentricArea>(models[i], runs, reference);
+    }
+}
+
+/**
+ * FROZEN BASELINE: load() as it was before its passes were fused (engine of doubles), kept unchanged for
+ * benchmark_passes, which compares it with the shipped load(); it is not used by the viewer. After the geometry of the
+ * triangles, one pass over the edges stores the mean curvature and the cotangent weight of each edge, one over the
+ * vertices stores the sums per vertex, then 2 passes over the triangles and one over the vertices compute the outputs
+ * from these sums.
+ */
+bool load_six_passes(BasicMeshCurvature<double, double> &mesh, const char *path, vector<float> out[9])
+{
+    if (!mesh.read_mesh(path) || !build_mesh_edges(mesh.t, mesh.num_vertices, mesh.mesh_edges))
+        return false;
+    build_vertex_adjacency(mesh.t, mesh.num_vertices, mesh.mesh_edges, mesh.vertex_adjacency);
+    int num_triangles = mesh.num_triangles, num_vertices = mesh.num_vertices;
+    const vector<Triangle> &t = mesh.t;
+    const MeshEdges &edges = mesh.mesh_edges;
+    const VertexPositions<double> &positions = mesh.positions;
+
+    vector<double> corner_angle(num_triangles * 3), corner_cot(num_triangles * 3), corner_area_mixed(num_triangles * 3), triangle_area(num_triangles);
+    mesh.set_max_min_mesh();
+    build_vertex_positions(mesh.v, mesh.min_coord, mesh.max_coord, interval, mesh.positions, mesh.threads);
+    mesh.v.clear();
+    mesh.v.shrink_to_fit();
+    double file_scale = mesh.get_file_scale();
+
+    TriangleGeometry<double> geometry = {corner_angle.data(), corner_area_mixed.data(), corner_cot.data(), triangle_area.data()};
+    parallel_for(num_triangles, mesh.threads, [&](int begin, int end) {
+        compute_triangle_geometry(mesh.t.data(), positions.x.data(), positions.y.data(), positions.z.data(), begin, end, geometry, mesh.use_simd_kernel);
+    });
+
+    // edges: mean curvature and cotangent weight
+    int edges_count = edges.edges_count();
+    vector<double> edge_mean_curvature(edges_count, 0.0), edge_cot_weight(edges_count, 0.0);
+    parallel_for(edges_count, mesh.threads, [&](int begin, int end) {
+        for (int e = begin; e < end; e++)
+        {
+            Point3d n1, n2;
+            double cot_alpha = 0, cot_beta = 0, area_t1 = 0, area_t2 = 0;
+            for (int i = edges.sides_begin[e]; i < edges.sides_begin[e + 1]; i++)
+            {
+                int corner = edges.sides[i], k = corner / 3, c = corner % 3;
+                if (t[k].v[(c + 1) % 3] < t[k].v[(c + 2) % 3])
+                {
+                    n1 = t[k].n;
+                    cot_alpha = corner_cot[corner];
+                    area_t1 = triangle_area[k];
+                }
+                else
+                {
+                    n2 = t[k].n;
+                    cot_beta = corner_cot[corner];
+                    area_t2 = triangle_area[k];
+                }
+            }
+            edge_cot_weight[e] = cot_alpha + cot_beta;
+            if (edges.sides_begin[e + 1] - edges.sides_begin[e] < 2)
+                continue;
+
+            Point3d edge_vector = (positions.get(edges.edge_v2[e]) - positions.get(edges.edge_v1[e])) * file_scale;
+            double value = edge_vector.norm() * (n1.getAngle(n2) / 2.0f) / ((area_t1 + area_t2) / 3.0f);
+            double determinant = edge_vector[0] * (n1[1] * n2[2] - n1[2] * n2[1]) - n1[0] * (edge_vector[1] * n2[2] - edge_vector[2] * n2[1]) + n2[0] * (edge_vector[1] * n1[2] - edge_vector[2] * n1[1]);
+            edge_mean_curvature[e] = determinant < 0.0 ? -value : value;
+        }
+    });
+
+    // vertices: sums
+    vector<Point3d> normals(num_vertices), mean_curvature_vertex_sum(num_vertices);
+    vector<double> value_angle_defeact_sum(num_vertices), area_mixed(num_vertices), vector_mc_sum(num_vertices);
+    parallel_for(num_vertices, mesh.threads, [&](int begin, int end) {
+        for (int k = begin; k < end; k++)
+        {
+            Point3d normal(0, 0, 0), mc_vertex_sum(0, 0, 0);
+            double angle_defeact_sum = 0, area_mixed_sum = 0, mc_sum = 0;
+            for (int i = mesh.vertex_adjacency.corners_begin[k]; i < mesh.vertex_adjacency.corners_begin[k + 1]; i++)
+            {
+                int corner = mesh.vertex_adjacency.corners[i], index_triangle = corner / 3;
+                normal += t[index_triangle].n;
+                angle_defeact_sum += corner_angle[corner];
+                area_mixed_sum += corner_area_mixed[corner];
+                mc_sum += edge_mean_curvature[edges.corner_edges[corner]];
+                for (int j = 0; j < 3; j++)
+                {
+                    int other_corner = index_triangle * 3 + j;
+                    if (other_corner == corner || t[index_triangle].v[(j + 1) % 3] > t[index_triangle].v[(j + 2) % 3])
+                        continue;
+                    int e = edges.corner_edges[other_corner];
+                    int index_other = edges.edge_v1[e] == k ? edges.edge_v2[e] : edges.edge_v1[e];
+                    mc_vertex_sum += edge_cot_weight[e] * ((positions.get(k) - positions.get(index_other)) * file_scale);
+                }
+            }
+            int triangles_count = mesh.vertex_adjacency.get_triangles_count(k);
+            if (triangles_count != 0)
+                normal = normal / triangles_count;
+            normal.normalize();
+            normals[k] = normal;
+            value_angle_defeact_sum[k] = angle_defeact_sum;
+            area_mixed[k] = area_mixed_sum;
+            vector_mc_sum[k] = mc_sum;
+            mean_curvature_vertex_sum[k] = mc_vertex_sum;
+        }
+    });
+
+    for (int i = 0; i < 6; i++)
+        out[i].resize((size_t)num_triangles * 9);
+    out[7].resize((size_t)num_triangles * 3);
+    out[6].resize(num_vertices);
+    out[8].resize(num_vertices);
+
+    // triangles: Gaussian curvature
+    parallel_for(num_triangles, mesh.threads, [&](int begin, int end) {
+        for (int k = begin; k < end; k++)
+            for (int j = 0; j < 3; j++)
+            {
+                float current_gc = ((2 * M_PI) - value_angle_defeact_sum[t[k].v[j]]) / area_mixed[t[k].v[j]];
+                for (int i = 0; i < 3; i++)
+                    out[3][(size_t)k * 9 + j * 3 + i] = current_gc;
+            }
+    });
+
+    // triangles: the other outputs
+    parallel_for(num_triangles, mesh.threads, [&](int begin, int end) {
+        for (int k = begin; k < end; k++)
+        {
+            size_t first = (size_t)k * 9;
+            for (int j = 0; j < 3; j++)
+            {
+                int index_vertex = t[k].v[j];
+                float mean_curvature = (((1.0f / (2 * area_mixed[index_vertex])) * mean_curvature_vertex_sum[index_vertex]).norm()) / 2.0f;
+                if (mean_curvature_vertex_sum[index_vertex] * normals[index_vertex] < 0)
+                    mean_curvature = -mean_curvature;
+                float mean_curvature_edge = edge_mean_curvature[edges.corner_edges[k * 3 + j]];
+                for (int i = 0; i < 3; i++)
+                {
+                    out[5][first + j * 3 + i] = mean_curvature;
+                    out[0][first + j * 3 + i] = i == 0 ? positions.x[index_vertex] : i == 1 ? positions.y[index_vertex] : positions.z[index_vertex];
+                    out[1][first + j * 3 + i] = normals[index_vertex][i];
+                    out[2][first + j * 3 + i] = t[k].n[i];
+                    out[4][first + j * 3 + i] = mean_curvature_edge;
+                }
+                out[7][(size_t)k * 3 + j] = mean_curvature_edge;
+            }
+        }
+    });
+
+    // vertices: outputs per vertex
+    parallel_for(num_vertices, mesh.threads, [&](int begin, int end) {
+        for (int k = begin; k < end; k++)
+        {
+            out[6][k] = ((2 * M_PI) - value_angle_defeact_sum[k]) / area_mixed[k];
+            float mean_curvature = (((1.0f / (2 * area_mixed[k])) * mean_curvature_vertex_sum[k]).norm()) / 2.0f;
+            out[8][k] = mean_curvature_vertex_sum[k] * normals[k] < 0 ? -mean_curvature : mean_curvature;
+        }
+    });
+    mesh.mesh_edges.clear();
+    return true;
+}
+
+/**
+ * Time of load() with the 4 passes over the triangles, the edges and the vertices, and with the previous 6 passes
+ * (engines of doubles, the mesh is read from its cache): throughput in triangles per second and biggest difference of the outputs.
+ */
+void benchmark_passes(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/genus3.off", "models/horse.off"};
+
+    printf("%-24s %10s %14s %14s %12s %12s %8s %12s\n", "model", "triangles", "6 passes (ms)", "4 passes (ms)", "6 (Mtri/s)", "4 (Mtri/s)", "speedup", "difference");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        vector<float> before[9], after[9];
+        double time_before = 1e30, time_after = 1e30;
+        int triangles_count = 0;
+        for (int run = 0; run < runs; run++) // alternated, both see the same state of the machine
+        {
+            time_before = min(time_before, best_time_ms(1, [&]() {
+                                  BasicMeshCurvature<double, double> mesh;
+                                  for (int k = 0; k < 9; k++)
+                                      before[k].clear();
+                                  load_six_passes(mesh, models[i], before);
+                              }));
+            time_after = min(time_after, best_time_ms(1, [&]() {
+                                 BasicMeshCurvature<double, double> mesh;
+                                 for (int k = 0; k < 9; k++)
+                                     after[k].clear();
+                                 mesh.load(models[i], after[0], after[1], after[2], after[3], after[4], after[5], after[6], after[7], after[8]);
+                                 triangles_count = mesh.num_triangles;
+                             }));
+        }
+
+        double difference = 0;
+        for (int k = 0; k < 9; k++)
+            difference = max(difference, get_max_relative_difference(before[k], after[k]));
+        printf("%-24s %10d %14.3f %14.3f %12.2f %12.2f %7.2fx %12.2g\n", models[i], triangles_count, time_before, time_after,
+               triangles_count / time_before / 1000, triangles_count / time_after / 1000, time_before / time_after, difference);
+    }
+}
+
+/**
+ * Patch of count vertices around seed (breadth-first over the neighbours), as moved by a brush.
+ */
+void get_vertex_patch(const VertexAdjacency &adjacency, int seed, int count, vector<int> &patch)
+{
+    vector<char> is_in_patch(adjacency.corners_begin.size() - 1, 0);
+    patch.assign(1, seed);
+    is_in_patch[seed] = 1;
+    for (size_t i = 0; i < patch.size() && (int)patch.size() < count; i++)
+        for (int n = adjacency.neighbours_begin[patch[i]]; n < adjacency.neighbours_begin[patch[i] + 1] && (int)patch.size() < count; n++)
+            if (!is_in_patch[adjacency.neighbours[n]])
+            {
+                is_in_patch[adjacency.neighbours[n]] = 1;
+                patch.push_back(adjacency.neighbours[n]);
+            }
+}
+
+/**
+ * Incremental updates (update_vertices) of patches of 1, 10, 100... moved vertices compared with the 4 passes of load()
+ * on the whole mesh (compute_curvatures): time, triangles changed, and biggest difference between the updated outputs
+ * and the outputs computed again from scratch (without the AVX2 kernel, so both compute the triangles the same way).
+ */
+void benchmark_updates(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/horse.off"};
+    const int patch_sizes[] = {1, 10, 100, 1000, 10000};
+
+    printf("%-24s %10s %10s %12s %12s %10s %12s\n", "model", "moved", "triangles", "update (ms)", "full (ms)", "speedup", "difference");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        MeshCurvature mesh;
+        mesh.use_incremental_updates = true;
+        mesh.use_simd_kernel = false;
+        vector<float> out[9], full[9];
+        if (!mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]))
+            continue;
+        double time_full = best_time_ms(runs, [&]() {
+            mesh.compute_curvatures(full[0], full[1], full[2], full[3], full[4], full[5], full[6], full[7], full[8]);
+        });
+
+        for (size_t p = 0; p < sizeof(patch_sizes) / sizeof(patch_sizes[0]); p++)
+        {
+            vector<int> patch;
+            get_vertex_patch(mesh.vertex_adjacency, mesh.num_vertices / 3, patch_sizes[p], patch);
+            vector<Point3d> new_positions(patch.size());
+            CurvatureUpdate update;
+            double time_update = 1e30;
+            for (int run = 0; run < runs; run++) // a push of the brush along z, back and forth
+            {
+                double offset = (run % 2 == 0 ? 1 : -1) * 0.002;
+                for (size_t k = 0; k < patch.size(); k++)
+                    new_positions[k] = Point3d(mesh.positions.get(patch[k])) + Point3d(0, 0, offset);
+                time_update = min(time_update, best_time_ms(1, [&]() {
+                                      mesh.update_vertices(patch, new_positions, out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8], update);
+                                  }));
+            }
+
+            mesh.compute_curvatures(full[0], full[1], full[2], full[3], full[4], full[5], full[6], full[7], full[8]);
+            double difference = 0;
+            for (int k = 0; k < 9; k++)
+                difference = max(difference, get_max_relative_difference(full[k], out[k]));
+            printf("%-24s %10zu %10zu %12.4f %12.3f %9.0fx %12.2g\n", models[i], patch.size(), update.triangles.size(), time_update, time_full, time_full / time_update, difference);
+        }
+    }
+}
+
+/**
+ * Principal curvatures (PrincipalCurvatures.h): time of load() without and with them, consistency with the other
+ * curvatures (k1 k2 = K where H^2 >= K, (k1 + k2) / 2 = H, per vertex in the rescaled coords), orthonormality of the
+ * directions with the normal, and biggest difference after update_vertices with the values computed again from scratch.
+ */
+void benchmark_principal(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/horse.off", "models/icosahedron_4.off"};
+
+    printf("%-28s %10s %14s %12s %12s %12s %12s %12s\n", "model", "load (ms)", "principal (ms)", "umbilic (%)", "K error", "H error", "orthonormal", "update diff");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        vector<float> out[9];
+        PrincipalCurvatureOutputs principal;
+        double time_load = 1e30, time_principal = 1e30;
+        for (int run = 0; run < runs; run++) // alternated, both see the same state of the machine
+        {
+            time_load = min(time_load, best_time_ms(1, [&]() {
+                                MeshCurvature mesh;
+                                mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]);
+                            }));
+            time_principal = min(time_principal, best_time_ms(1, [&]() {
+                                     MeshCurvature mesh;
+                                     mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8], &principal);
+                                 }));
+        }
+
+        MeshCurvature mesh;
+        mesh.use_incremental_updates = true;
+        mesh.use_simd_kernel = false;
+        if (!mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8], &principal))
+            continue;
+
+        // K and H of the vertices where the discriminant is not clamped to 0 (the others are umbilic)
+        int umbilic = 0;
+        double error_gaussian = 0, error_mean = 0, error_orthonormal = 0;
+        for (int k = 0; k < mesh.num_vertices; k++)
+        {
+            const float *curvatures = &principal.curvatures_vertex[(size_t)k * 2];
+            const float *directions = &principal.directions_vertex[(size_t)k * 6];
+            double mean_curvature = out[8][k] / mesh.get_file_scale();
+            if (curvatures[0] == curvatures[1])
+                umbilic++;
+            else
+                error_gaussian = max(error_gaussian, fabs(curvatures[0] * curvatures[1] - out[6][k]) / max(1.0, fabs((double)out[6][k])));
+            error_mean = max(error_mean, fabs((curvatures[0] + curvatures[1]) / 2 - mean_curvature) / max(1.0, fabs(mean_curvature)));
+
+            Point3d direction_1(directions[0], directions[1], directions[2]), direction_2(directions[3], directions[4], directions[5]);
+            Point3d normal(out[1][mesh.vertex_adjacency.corners[mesh.vertex_adjacency.corners_begin[k]] * 3], out[1][mesh.vertex_adjacency.corners[mesh.vertex_adjacency.corners_begin[k]] * 3 + 1], out[1][mesh.vertex_adjacency.corners[mesh.vertex_adjacency.corners_begin[k]] * 3 + 2]);
+            if (mesh.vertex_adjacency.get_triangles_count(k) == 0)
+                continue;
+            error_orthonormal = max(error_orthonormal, max(fabs(direction_1.norm() - 1), fabs(direction_2.norm() - 1)));
+            error_orthonormal = max(error_orthonormal, max(fabs(direction_1 * direction_2), max(fabs(direction_1 * normal), fabs(direction_2 * normal))));
+        }
+
+        // a patch of 100 vertices pushed along z, then everything computed again
+        vector<int> patch;
+        get_vertex_patch(mesh.vertex_adjacency, mesh.num_vertices / 3, 100, patch);
+        vector<Point3d> new_positions(patch.size());
+        for (size_t k = 0; k < patch.size(); k++)
+            new_positions[k] = Point3d(mesh.positions.get(patch[k])) + Point3d(0, 0, 0.002);
+        CurvatureUpdate update;
+        mesh.update_vertices(patch, new_positions, out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8], update, &principal);
+        vector<float> full[9];
+        PrincipalCurvatureOutputs full_principal;
+        mesh.compute_curvatures(full[0], full[1], full[2], full[3], full[4], full[5], full[6], full[7], full[8], &full_principal);
+        double difference = max(get_max_relative_difference(full_principal.curvatures, principal.curvatures), get_max_relative_difference(full_principal.directions_1, principal.directions_1));
+        difference = max(difference, max(get_max_relative_difference(full_principal.directions_2, principal.directions_2), get_max_relative_difference(full_principal.curvatures_vertex, principal.curvatures_vertex)));
+        difference = max(difference, get_max_relative_difference(full_principal.directions_vertex, principal.directions_vertex));
+
+        printf("%-28s %10.3f %14.3f %12.2f %12.2g %12.2g %12.2g %12.2g\n", models[i], time_load, time_principal, 100.0 * umbilic / mesh.num_vertices,
+               error_gaussian, error_mean, error_orthonormal, difference);
+    }
+}
+
+/**
+ * Spread of values: distance between the 5th and the 95th percentile.
+ */
+double get_percentile_spread(vector<float> values)
+{
+    if (values.empty())
+        return 0;
+    size_t low = values.size() / 20, high = values.size() - 1 - values.size() / 20;
+    nth_element(values.begin(), values.begin() + low, values.end());
+    float low_value = values[low];
+    nth_element(values.begin(), values.begin() + high, values.end());
+    return values[high] - low_value;
+}
+
+/**
+ * Multi-scale curvatures (MultiScaleCurvature.h): time to find the neighbourhoods (once per load), time to average
+ * the Gaussian and the mean curvature at 5 scales in one pass and one scale at a time (as the slider of main.cpp),
+ * spread of the Gaussian curvature at each scale (the noise of the one-ring values goes down), and checks that the
+ * scales of the one pass are the same as the single ones and the same with one thread.
+ */
+void benchmark_multiscale(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/horse.off"};
+    struct
+    {
+        NeighbourhoodType type;
+        double scales[5];
+    } settings[] = {{NEIGHBOURHOOD_K_RING, {0, 1, 2, 3, 4}}, {NEIGHBOURHOOD_RADIUS, {0, 0.0125, 0.025, 0.0375, 0.05}}};
+
+    printf("%-24s %-8s %10s %12s %12s %12s %-44s %6s\n", "model", "type", "build (ms)", "entries (MB)", "5 scales (ms)", "1 scale (ms)", "spread of gc at each scale", "same");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        MeshCurvature mesh;
+        vector<float> out[9];
+        if (!mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]))
+            continue;
+        const vector<float> *values[] = {&out[6], &out[8]};
+
+        for (size_t t = 0; t < sizeof(settings) / sizeof(settings[0]); t++)
+        {
+            vector<double> scales(settings[t].scales, settings[t].scales + 5);
+            VertexNeighbourhoods neighbourhoods, serial_neighbourhoods;
+            double time_build = best_time_ms(runs, [&]() {
+                build_vertex_neighbourhoods(mesh.t, mesh.positions, mesh.vertex_adjacency, settings[t].type, scales.back(), neighbourhoods, mesh.threads);
+            });
+            build_vertex_neighbourhoods(mesh.t, mesh.positions, mesh.vertex_adjacency, settings[t].type, scales.back(), serial_neighbourhoods, 1);
+
+            vector<vector<float> > together, single, serial;
+            double time_together = best_time_ms(runs, [&]() {
+                evaluate_multiscale_curvature(neighbourhoods, values, 2, scales, together, mesh.threads);
+            });
+            double time_single = best_time_ms(runs, [&]() {
+                evaluate_multiscale_curvature(neighbourhoods, values, 2, vector<double>(1, scales[2]), single, mesh.threads);
+            });
+            evaluate_multiscale_curvature(serial_neighbourhoods, values, 2, scales, serial, 1);
+
+            bool same = together[0] == out[6] && together[1] == out[8] && serial == together;
+            char spreads[64] = "";
+            for (size_t s = 0; s < scales.size(); s++)
+            {
+                evaluate_multiscale_curvature(neighbourhoods, values, 2, vector<double>(1, scales[s]), single, mesh.threads);
+                same = same && single[0] == together[s * 2] && single[1] == together[s * 2 + 1];
+                snprintf(spreads + strlen(spreads), sizeof(spreads) - strlen(spreads), "%8.2f", get_percentile_spread(together[s * 2]));
+            }
+            double megabytes = neighbourhoods.vertices.size() * (sizeof(int) + sizeof(float)) / (1024.0 * 1024.0);
+            printf("%-24s %-8s %10.3f %12.2f %12.3f %12.3f %-44s %6s\n", models[i], neighbourhood_names[settings[t].type], time_build, megabytes,
+                   time_together, time_single, spreads, same ? "yes" : "no");
+        }
+    }
+}
+
+/**
+ * Object end to end (set_file without the GL calls): the values per vertex and per edge it keeps are the outputs of
+ * load() in their order (the k-percentiles are computed on copies), its percentiles are those of the outputs, and the
+ * buffers of compute_curvature_scale are the averages of the outputs at each scale (scale 0: the buffers of load()),
+ * with the percentiles of those averages as bounds.
+ * After a patch of 100 vertices is moved by update_vertex_data, its arrays and percentiles are those of the engine.
+ */
+void benchmark_object(int runs)
+{
+    const char *models[] = {"models/armadillo.off", "models/horse.off"};
+    double scales[][3] = {{0, 1, 4}, {0, 0.0125, 0.05}};
+
+    printf("%-24s %-8s %10s %8s %12s %8s %8s\n", "model", "type", "load (ms)", "values", "percentiles", "scales", "update");
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++)
+    {
+        MeshCurvature mesh;
+        vector<float> out[9];
+        if (!mesh.load(models[i], out[0], out[1], out[2], out[3], out[4], out[5], out[6], out[7], out[8]))
+            continue;
+
+        // bounds of main.cpp before the first set_file
+        vector<double> bounds;
+        KPercentile percentile;
+        for (int k = 6; k < 9; k++)
+        {
+            vector<float> values(out[k]);
+            vector<double> percentiles = percentile.init(values);
+            bounds.insert(bounds.end(), percentiles.begin(), percentiles.end());
+        }
+
+        for (int type = NEIGHBOURHOOD_K_RING; type <= NEIGHBOURHOOD_RADIUS; type++)
+        {
+            use_multiscale_curvature = true;
+            use_incremental_updates = true;
+            multiscale_neighbourhood = (NeighbourhoodType)type;
+            Object object;
+            object.use_curvature_cache = false;
+            double time_load = best_time_ms(runs, [&]() {
+                object.set_file(models[i]);
+            });
+            use_multiscale_curvature = false;
+            use_incremental_updates = false;
+
+            bool same_values = object.triangle_gc_notduplicatevalue == out[6] && object.triangle_mc_notduplicatevalue == out[7] && object.triangle_mc_vertex_notduplicatevalue == out[8] &&
+                               object.triangle_gc == out[3] && object.triangle_mc_vertex == out[5];
+            double object_bounds[CURVATURE_CACHE_BOUNDS];
+            object.get_best_values(object_bounds);
+            bool same_percentiles = equal(bounds.begin(), bounds.end(), object_bounds);
+
+            VertexNeighbourhoods neighbourhoods;
+            build_vertex_neighbourhoods(mesh.t, mesh.positions, mesh.vertex_adjacency, (NeighbourhoodType)type, get_multiscale_max_scale(), neighbourhoods, mesh.threads);
+            const vector<float> *values[] = {&out[6], &out[8]};
+            vector<vector<float> > reference;
+            vector<double> object_scales(scales[type], scales[type] + 3);
+            evaluate_multiscale_curvature(neighbourhoods, values, 2, object_scales, reference, mesh.threads);
+            bool same_scales = true;
+            for (size_t s = 0; s < object_scales.size(); s++)
+            {
+                same_scales = same_scales && object.compute_curvature_scale(object_scales[s]);
+                for (int k = 0; k < mesh.num_triangles; k++)
+                    for (int c = 0; c < 9; c++)
+                    {
+                        int vertex = mesh.t[k].v[c / 3];
+                        same_scales = same_scales && object.triangle_gc[(size_t)k * 9 + c] == reference[s * 2][vertex] && object.triangle_mc_vertex[(size_t)k * 9 + c] == reference[s * 2 + 1][vertex];
+                    }
+                // bounds of the colours of the scale (gc and mc per vertex)
+                object.get_best_values(object_bounds);
+                for (int k = 0; k < 2; k++)
+                {
+                    vector<float> scaled_values(reference[s * 2 + k]);
+                    vector<double> percentiles = percentile.init(scaled_values);
+                    same_scales = same_scales && percentiles[0] == object_bounds[k * 4] && percentiles[1] == object_bounds[k * 4 + 1];
+                }
+            }
+            same_scales = same_scales && object.compute_curvature_scale(0) && object.triangle_gc == out[3] && object.triangle_mc_vertex == out[5];
+            object.get_best_values(object_bounds);
+            same_scales = same_scales && equal(bounds.begin(), bounds.end(), object_bounds);
+
+            // the same patch pushed along z in the object and in an engine of the same precision
+            MeshCurvature engine;
+            engine.use_incremental_updates = true;
+            vector<float> updated[9];
+            engine.load(models[i], updated[0], updated[1], updated[2], updated[3], updated[4], updated[5], updated[6], updated[7], updated[8]);
+            vector<int> patch;
+            get_vertex_patch(engine.vertex_adjacency, engine.num_vertices / 3, 100, patch);
+            vector<Point3d> new_positions(patch.size());
+            for (size_t k = 0; k < patch.size(); k++)
+                new_positions[k] = Point3d(engine.positions.get(patch[k])) + Point3d(0, 0, 0.002);
+            CurvatureUpdate update, object_update;
+            engine.update_vertices(patch, new_positions, updated[0], updated[1], updated[2], updated[3], updated[4], updated[5], updated[6], updated[7], updated[8], update);
+            bool same_update = object.update_vertex_data(patch, new_positions, object_update) && object_update.triangles == update.triangles;
+            vector<float> *object_arrays[CURVATURE_CACHE_ARRAYS];
+            object.get_cached_arrays(object_arrays);
+            int object_order[] = {0, 1, 2, 3, 5, 4, 6, 7, 8}; // outputs of load() in the arrays of the object
+            for (int k = 0; k < 9; k++)
+                same_update = same_update && *object_arrays[object_order[k]] == updated[k];
+            object.get_best_values(object_bounds);
+            for (int k = 6; k < 9; k++)
+            {
+                vector<float> values(updated[k]);
+                vector<double> percentiles = percentile.init(values);
+                same_update = same_update && percentiles[0] == object_bounds[(k - 6) * 2] && percentiles[1] == object_bounds[(k - 6) * 2 + 1];
+            }
+
+            printf("%-24s %-8s %10.3f %8s %12s %8s %8s\n", models[i], neighbourhood_names[type], time_load, same_values ? "yes" : "no", same_percentiles ? "yes" : "no", same_scales ? "yes" : "no",
+                   same_update ? "yes" : "no");
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    string mode = argc > 1 ? argv[1] : "";
+    int runs = argc > 2 ? atoi(argv[2]) : 5;
+
+    if (mode == "readers")
+        benchmark_readers(runs);
+    else if (mode == "tokenizer")
+        benchmark_tokenizer(runs);
+    else if (mode == "cache")
+        benchmark_mesh_cache(runs);
+    else if (mode == "curvature")
+        benchmark_curvature_cache(runs);
+    else if (mode == "streaming")
+        benchmark_streaming(runs);
+    else if (mode == "formats")
+        benchmark_formats(runs);
+    else if (mode == "welding")
+        benchmark_welding(runs);
+    else if (mode == "threads")
+        benchmark_parser_threads(runs);
+    else if (mode == "edges")
+        benchmark_edges(runs);
+    else if (mode == "onering")
+        benchmark_one_ring(runs);
+    else if (mode == "reorder")
+        benchmark_reorder(runs);
+    else if (mode == "kernel")
+        benchmark_kernel(runs);
+    else if (mode == "positions")
+        benchmark_positions(runs);
+    else if (mode == "trigfree")
+        benchmark_trig_free(runs);
+    else if (mode == "loadthreads")
+        benchmark_load_threads(runs);
+    else if (mode == "precision")
+        benchmark_precision(runs);
+    else if (mode == "estimators")
+        benchmark_estimators(runs);
+    else if (mode == "passes")
+        benchmark_passes(runs);
+    else if (mode == "engines")
+        benchmark_engines(runs);
+    else if (mode == "updates")
+        benchmark_updates(runs);
+    else if (mode == "principal")
+        benchmark_principal(runs);
+    else if (mode == "multiscale")
+        benchmark_multiscale(runs);
+    else if (mode == "object")
+        benchmark_object(runs);
+    else
+    {
+        cout << "usage: ./benchmark <mode> [runs]" << endl;
+        cout << "  readers    stream reader vs memory mapped reader on models/*" << endl;
+        cout << "  tokenizer  MB/s of istream, strtod and MeshTokenizer on armadillo, horse, genus3" << endl;
+        cout << "  cache      .OFF file vs binary mesh cache" << endl;
+        cout << "  curvature  load() vs curvature cache" << endl;
+        cout << "  streaming  load() vs out-of-core streaming curvature" << endl;
+        cout << "  formats    OFF vs PLY (binary, ascii) vs OBJ" << endl;
+        cout << "  welding    triangle soups welded with a spatial hash" << endl;
+        cout << "  threads    OFF parser with 1, 2, 4... threads" << endl;
+        cout << "  edges      std::map vs sorted corners (MeshEdges) in the edge phase of load() on armadillo, horse" << endl;
+        cout << "  onering    one-rings and edge triangles from the vertex adjacency vs searched in the triangles" << endl;
+        cout << "  reorder    ACMR and load() time of the file order vs Morton + Tipsify order" << endl;
+        cout << "  kernel     geometry of the triangles with the scalar path vs the AVX2 kernel" << endl;
+        cout << "  positions  memory of the vertices as Point3d and as float positions, time to read them" << endl;
+        cout << "  trigfree   speed and accuracy of the triangle geometry with and without angles, all the models" << endl;
+        cout << "  loadthreads load() with 1, 2, 4... threads" << endl;
+        cout << "  precision  load() time and curvature error of each precision of the engine and of the accumulation" << endl;
+        cout << "  estimators load() time and curvatures of each area estimator, with all or one of the curvature estimators" << endl;
+        cout << "  passes     load() with the 4 fused passes vs the previous 6 passes, triangles per second" << endl;
+        cout << "  engines    models loaded one after the other vs at the same time by one MeshCurvature per thread" << endl;
+        cout << "  updates    curvatures updated around 1, 10, 100... moved vertices vs computed again on the whole mesh" << endl;
+        cout << "  principal  load() with the principal curvatures and directions, consistency with K, H and the normals" << endl;
+        cout << "  multiscale curvatures averaged over k-rings and balls: neighbourhoods found once, every scale in one pass" << endl;
+        cout << "  object     Object::set_file, compute_curvature_scale and update_vertex_data (no GL calls) vs the outputs of the engine" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -9,6 +9,7 @@
 #include "Shader.h"
 #include "Arcball.h"
 #include "Object.h"
+#include "ObjectLoader.h"
 #include "LoaderObject.h"
 #include <math.h>
 #include <string>
@@ -46,6 +47,7 @@ void error_callback(int error, const char *desc);
 // create object
 Object object = Object();
 Object horse = Object();
+ObjectLoader object_loader; // loads the selected model while object is rendered
 
 // Camera options
 float Zoom = 45.0f;
@@ -78,6 +80,8 @@ void set_shader();
 void select_model(GLFWwindow *window);
 void analyse_gaussian_curvature(GLFWwindow *window, int prev, const char *title, int minimum, int maximum, int vector_values_size, const char *type_curvature, vector<float> vector_values, const char *untouched_name, const char *percentile_name, double percentile_minimum, double percentile_maximum);
 void initialize_texture_object(GLFWwindow *window, bool reload_mesh);
+void set_curvature_bounds();
+void update_loading(GLFWwindow *window);
 
 // set-up parameter imgui
 static float angle = 180.0f;                // angle of rotation - must be the same of transform_shader
@@ -101,6 +105,7 @@ static int mc_set_vertex = 2;
 // imgui listbox models
 static int listbox_item_current = 0;
 static int listbox_item_prev = 0;
+static int listbox_item_loading = 0;
 
 void set_parameters_shader(int selected_shader);
 
@@ -132,6 +137,23 @@ float min_val, max_val;
 
 int main(int argc, char *argv[])
 {
+    // precisions of the curvature engine: --precision float|double|long_double --accumulation float|double|long_double
+    // --positions float|geometry (positions stored in float or in the precision of the geometry)
+    for (int i = 1; i < argc; i += 2)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--precision") == 0 && get_curvature_precision(argv[i + 1], curvature_precision))
+            continue;
+        if (i + 1 < argc && strcmp(argv[i], "--accumulation") == 0 && get_curvature_precision(argv[i + 1], accumulation_precision))
+            continue;
+        if (i + 1 < argc && strcmp(argv[i], "--positions") == 0 && (strcmp(argv[i + 1], "float") == 0 || strcmp(argv[i + 1], "geometry") == 0))
+        {
+            use_float_positions = strcmp(argv[i + 1], "float") == 0;
+            continue;
+        }
+        cout << "Usage: " << argv[0] << " [--precision float|double|long_double] [--accumulation float|double|long_double] [--positions float|geometry]" << endl;
+        return -1;
+    }
+
     set_parameters_shader(shader_set);
 
     /**
@@ -230,6 +252,9 @@ int main(int argc, char *argv[])
         // keyboard
         process_input(window);
 
+        // a model loaded in background is ready: upload it (GL calls stay on this thread)
+        update_loading(window);
+
         glEnable(GL_DEPTH_TEST);
 
         // Render to our framebuffer
@@ -713,26 +738,94 @@ void set_parameters_shader(int selected_shader)
 }
 
 // function to select a model to render
+// listbox_item_prev is the model rendered and listbox_item_loading the one being loaded: a new selection is loaded
+// when the previous load ends (see update_loading)
 void select_model(GLFWwindow *window)
 {
-    listbox_item_prev = listbox_item_current;
     ImGui::TextWrapped("Select a model to render:\n\n");
     const char *listbox_items[] = {"armadillo", "eight", "genus3", "horse", "icosahedron_1", "icosahedron_2", "icosahedron_3", "icosahedron_4"};
     ImGui::PushItemWidth(-1);
     ImGui::ListBox("", &listbox_item_current, listbox_items, IM_ARRAYSIZE(listbox_items), 10);
 
-    name_file = "models/" + std::string(listbox_items[listbox_item_current]) + ".off"; // generate name file
+    // welding and reordering change the mesh: the model is loaded again
+    // (use_vertex_welding, use_mesh_reordering and the precisions are read by the worker, they are set before a load)
+    static bool is_welding_selected = use_vertex_welding;
+    ImGui::Checkbox("Weld coincident vertices", &is_welding_selected);
+    static bool is_reordering_selected = use_mesh_reordering;
+    ImGui::Checkbox("Reorder for cache locality", &is_reordering_selected);
+
+    // precisions of the engine (see BasicMeshCurvature): the model is loaded again too
+    static int precision_selected = curvature_precision;
+    ImGui::Combo("Precision", &precision_selected, precision_names, IM_ARRAYSIZE(precision_names));
+    static int accumulation_selected = accumulation_precision;
+    ImGui::Combo("Accumulation", &accumulation_selected, precision_names, IM_ARRAYSIZE(precision_names));
+    static bool is_float_positions_selected = use_float_positions;
+    ImGui::Checkbox("Float positions", &is_float_positions_selected);
+
+    // multi-scale curvatures (see MultiScaleCurvature.h): the neighbourhoods are found by the load
+    static bool is_multiscale_selected = use_multiscale_curvature;
+    ImGui::Checkbox("Multi-scale curvature", &is_multiscale_selected);
+    static int neighbourhood_selected = multiscale_neighbourhood;
+    if (is_multiscale_selected)
+        ImGui::Combo("Neighbourhood", &neighbourhood_selected, neighbourhood_names, IM_ARRAYSIZE(neighbourhood_names));
+
+    if ((listbox_item_current != listbox_item_prev || is_welding_selected != use_vertex_welding || is_reordering_selected != use_mesh_reordering ||
+         precision_selected != curvature_precision || accumulation_selected != accumulation_precision || is_float_positions_selected != use_float_positions ||
+         is_multiscale_selected != use_multiscale_curvature || neighbourhood_selected != multiscale_neighbourhood) &&
+        !object_loader.is_loading())
+    {
+        use_vertex_welding = is_welding_selected;
+        use_mesh_reordering = is_reordering_selected;
+        curvature_precision = (CurvaturePrecision)precision_selected;
+        accumulation_precision = (CurvaturePrecision)accumulation_selected;
+        use_float_positions = is_float_positions_selected;
+        use_multiscale_curvature = is_multiscale_selected;
+        multiscale_neighbourhood = (NeighbourhoodType)neighbourhood_selected;
+        object_loader.start("models/" + std::string(listbox_items[listbox_item_current]) + ".off");
+        listbox_item_loading = listbox_item_current;
+    }
+
+    // scale of the Gaussian and mean curvature per vertex shown: only the averages are computed again
+    if (!object.corner_vertices.empty())
+    {
+        bool is_k_ring = object.curvature_neighbourhoods.type == NEIGHBOURHOOD_K_RING;
+        float scale_selected = object.curvature_scale;
+        if (ImGui::SliderFloat("Curvature scale", &scale_selected, 0.0f, (float)object.curvature_neighbourhoods.max_scale, is_k_ring ? "%.0f rings" : "%.3f") &&
+            object.set_curvature_scale(is_k_ring ? floor(scale_selected + 0.5f) : min((double)scale_selected, object.curvature_neighbourhoods.max_scale)))
+            set_curvature_bounds(); // the averages have narrower bounds
+    }
 
-    if (listbox_item_current != listbox_item_prev)
+    if (object_loader.is_loading())
     {
-        // clean/delete all resources that were allocated
-        object.clear();
-        glDeleteFramebuffers(1, &frame_buffer);
-        glDeleteTextures(1, &rendered_texture);
-        glDeleteRenderbuffers(1, &depth_render_buffer);
+        string overlay = "Loading " + object_loader.get_path();
+        ImGui::ProgressBar(object_loader.get_progress(), ImVec2(-1, 0), overlay.c_str());
+    }
+}
+
+// function to replace the rendered model with the one loaded in background (see select_model)
+void update_loading(GLFWwindow *window)
+{
+    if (!object_loader.is_finished())
+        return;
 
-        initialize_texture_object(window, true);
+    if (!object_loader.take(object))
+    {
+        // the rendered model stays selected, choosing the model again loads it again
+        cout << "error loading " << object_loader.get_path() << endl;
+        if (listbox_item_current == listbox_item_loading)
+            listbox_item_current = listbox_item_prev;
+        return;
     }
+    name_file = object_loader.get_path();
+    listbox_item_prev = listbox_item_loading;
+
+    // clean/delete all resources that were allocated
+    object.clear();
+    glDeleteFramebuffers(1, &frame_buffer);
+    glDeleteTextures(1, &rendered_texture);
+    glDeleteRenderbuffers(1, &depth_render_buffer);
+
+    initialize_texture_object(window, false);
 }
 
 /**
@@ -874,32 +967,12 @@ void analyse_gaussian_curvature(GLFWwindow *window, int prev, const char *title,
     }
 }
 
-void initialize_texture_object(GLFWwindow *window, bool reload_mesh)
+/**
+ * Bounds of the colours of the curvatures (minimum and maximum or k-percentile, see gc_set, mc_set_edge, mc_set_vertex)
+ * from the values of the object: after a load and after a change of the curvature scale.
+ */
+void set_curvature_bounds()
 {
-    // --------- SET UP ------------
-    // Black background
-    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-
-    // Enable depth test
-    glEnable(GL_DEPTH_TEST);
-    // Accept fragment if it closer to the camera than the former one
-    glDepthFunc(GL_LESS);
-
-    // Cull triangles which normal is not towards the camera
-    glEnable(GL_CULL_FACE);
-    // ----------------------
-
-    /**
-        NB. OpenGL works in 3D space we render a 2D triangle with each vertex having a z coordinate of 0.0.
-        This way the depth of the triangle remains the same making it look like it's 2D.
-
-        Send vertex data to vertex shader (load .off file).
-     */
-    // object.set_file(name_file, std::bind(&Object::auto_detect_outliers_gc, Object()), std::bind(&Object::set_selected_gc, Object()), std::bind(&Object::init, Object())); //load mesh
-    if (reload_mesh)
-        object.set_file(name_file); //load mesh
-    object.init();
-
     switch (gc_set)
     {
     case 1:
@@ -932,6 +1005,35 @@ void initialize_texture_object(GLFWwindow *window, bool reload_mesh)
         global_min_mc_vertex = object.get_best_values_mc_vertex()[0];
         global_max_mc_vertex = object.get_best_values_mc_vertex()[1];
     }
+}
+
+void initialize_texture_object(GLFWwindow *window, bool reload_mesh)
+{
+    // --------- SET UP ------------
+    // Black background
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+    // Enable depth test
+    glEnable(GL_DEPTH_TEST);
+    // Accept fragment if it closer to the camera than the former one
+    glDepthFunc(GL_LESS);
+
+    // Cull triangles which normal is not towards the camera
+    glEnable(GL_CULL_FACE);
+    // ----------------------
+
+    /**
+        NB. OpenGL works in 3D space we render a 2D triangle with each vertex having a z coordinate of 0.0.
+        This way the depth of the triangle remains the same making it look like it's 2D.
+
+        Send vertex data to vertex shader (load .off file).
+     */
+    // object.set_file(name_file, std::bind(&Object::auto_detect_outliers_gc, Object()), std::bind(&Object::set_selected_gc, Object()), std::bind(&Object::init, Object())); //load mesh
+    if (reload_mesh)
+        object.set_file(name_file); //load mesh
+    object.init();
+
+    set_curvature_bounds();
 
     /**
         IMPORTANT FOR TRANSFORMATION:
@@ -1,6 +1,8 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+layout (location = 7) in vec3 principalDirection1;
+layout (location = 8) in vec3 principalDirection2;
 
 out VS_OUT {
     vec3 normal;
@@ -9,10 +11,12 @@ out VS_OUT {
 uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
+uniform int shownDirection; // 1: direction of k1, 2: direction of k2 (0: normal)
 
 void main()
 {
     mat3 normalMatrix = mat3(transpose(inverse(view * model)));
-    vs_out.normal = vec3(projection * vec4(normalMatrix * aNormal, 0.0));
+    vec3 direction = shownDirection == 1 ? principalDirection1 : (shownDirection == 2 ? principalDirection2 : aNormal);
+    vs_out.normal = vec3(projection * vec4(normalMatrix * direction, 0.0));
     gl_Position = projection * view * model * vec4(aPos, 1.0); 
 }
\ No newline at end of file
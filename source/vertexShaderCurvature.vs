@@ -4,6 +4,7 @@
     layout (location = 2) in vec3 gaussian_curvature;
     layout (location = 3) in vec3 mean_curvature_edge;
     layout (location = 4) in vec3 mean_curvature_vertex;
+    layout (location = 6) in vec2 principal_curvatures; // k1, k2 of the vertex
 
     out vec4 color;
 
@@ -16,6 +17,7 @@
 
     uniform bool isGaussian;
     uniform bool isMeanCurvatureEdge;
+    uniform int principalCurvature; // 1: k1, 2: k2 (0: the curvature chosen by isGaussian and isMeanCurvatureEdge)
 
     vec3 interpolation(vec3 v0, vec3 v1, float t) {
         return (1 - t) * v0 + t * v1;
@@ -36,6 +38,9 @@
         } else if(!isGaussian && isMeanCurvatureEdge){
             val = mean_curvature_edge[0]; // mean curvature is a vec3 composed by same value
         }
+        if(principalCurvature > 0){
+            val = principal_curvatures[principalCurvature - 1];
+        }
 
        // colors in HSV
        vec3 red = vec3(0.0, 1.0, 1.0); //h s v